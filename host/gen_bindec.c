@@ -0,0 +1,53 @@
+/*
+ *  File name:  gen_bindec.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host program to generate lookup tables for lib_fastdec.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Writes bindec_lut.h to stdout (see Makefile):
+ *  bindec_dec2[200] has "00" to "99", bindec_hex[512] has "00" to "FF".
+ */
+
+#include <stdio.h>
+
+static void put_table(const char *, int, const char *);
+
+int main(void)
+{
+    printf("/*\n"
+	   " *  File name:  bindec_lut.h\n"
+	   " *\n"
+	   " *  Generated by host/gen_bindec.c. Do not edit.\n"
+	   " */\n\n");
+    put_table("bindec_dec2", 100, "%02d");
+    put_table("bindec_hex", 256, "%02X");
+    return 0;
+}
+
+/******************************************************************************
+ *
+ *  Print one table as 2 chars per entry, 16 entries per line
+ *  in: name, entry count, printf format for entry
+ */
+
+static void put_table(const char *name, int count, const char *format)
+{
+    int		i;
+
+    printf("static const char %s[%d] =\n", name, count * 2);
+    for (i = 0; i < count; i++) {
+	if (!(i & 15))
+	    printf("    \"");
+	printf(format, i);
+	if ((i & 15) == 15 || i == count - 1)
+	    printf("\"%s\n", i == count - 1 ? ";\n" : "");
+    }
+}
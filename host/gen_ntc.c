@@ -0,0 +1,192 @@
+/*
+ *  File name:  gen_ntc.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host program to generate the NTC table for lib_thermo.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Writes thermo_lut.h to stdout (see NTC in Makefile):
+ *
+ *	gen_ntc beta r25 rdiv vref vsup shift
+ *
+ *  beta:	NTC beta (B25/85), kelvin
+ *  r25:	NTC resistance at 25 C, ohms
+ *  rdiv:	divider resistor from vsup to the NTC, ohms
+ *  vref:	ADC reference, millivolts
+ *  vsup:	divider supply, millivolts (same as vref when ratiometric)
+ *  shift:	table step is 2^shift ADC counts, 1 to 6 (each step down
+ *		doubles the table, and cuts the error at the hot end)
+ *
+ *  The NTC is from the ADC input to ground. thermo_ntc[] has tenths C at
+ *  every 2^NTC_SHIFT counts of the 10 bit ADC, from the beta formula,
+ *  held to TEMP_MIN and TEMP_MAX. It is only there with NTC_TABLE
+ *  defined, so other modules can use the NTC values without a copy.
+ *  The header comment gives the worst error of the straight lines
+ *  between entries, for ranges of 10 C.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ADC_COUNTS	1024
+#define SHIFT_MIN	1
+#define SHIFT_MAX	6	/* entry differences times step fit 16 bits */
+
+#define TEMP_MIN	-400	/* tenths C */
+#define TEMP_MAX	1500
+
+#define KELVIN		273.15
+
+static double	beta, r25, rdiv, vref, vsup;
+static int	shift;
+
+static double adc_temp(double);
+static int table_temp(int);
+static void put_errors(const int *);
+
+int main(int argc, char **argv)
+{
+    int		table[ADC_COUNTS / (1 << SHIFT_MIN) + 1];
+    int		entries, i;
+
+    if (argc != 7) {
+	fprintf(stderr, "usage: gen_ntc beta r25 rdiv vref vsup shift\n");
+	return 1;
+    }
+    beta = atof(argv[1]);
+    r25 = atof(argv[2]);
+    rdiv = atof(argv[3]);
+    vref = atof(argv[4]);
+    vsup = atof(argv[5]);
+    shift = atoi(argv[6]);
+    if (beta <= 0 || r25 <= 0 || rdiv <= 0 || vref <= 0 || vsup <= 0) {
+	fprintf(stderr, "gen_ntc: values must be above zero\n");
+	return 1;
+    }
+    if (shift < SHIFT_MIN || shift > SHIFT_MAX) {
+	fprintf(stderr, "gen_ntc: shift must be %d to %d\n", SHIFT_MIN,
+		SHIFT_MAX);
+	return 1;
+    }
+
+    entries = ADC_COUNTS / (1 << shift) + 1;
+    for (i = 0; i < entries; i++)
+	table[i] = table_temp(i << shift);
+
+    printf("/*\n"
+	   " *  File name:  thermo_lut.h\n"
+	   " *\n"
+	   " *  Generated by host/gen_ntc.c. Do not edit.\n"
+	   " *\n"
+	   " *  NTC B %s, %s ohms at 25 C, %s ohm divider,\n"
+	   " *  ADC reference %s mV, divider supply %s mV.\n"
+	   " *  %d entries, every %d ADC counts.\n"
+	   " *\n"
+	   " *  Worst error of lookup from formula, C:\n",
+	   argv[1], argv[2], argv[3], argv[4], argv[5], entries, 1 << shift);
+    put_errors(table);
+    printf(" */\n\n");
+
+    printf("#define NTC_BETA\t%s\n", argv[1]);
+    printf("#define NTC_R25\t\t%s\n", argv[2]);
+    printf("#define NTC_RDIV\t%s\n", argv[3]);
+    printf("#define NTC_VREF\t%s\n", argv[4]);
+    printf("#define NTC_VSUP\t%s\n", argv[5]);
+    printf("#define NTC_SHIFT\t%d\n\n", shift);
+
+    printf("#ifdef NTC_TABLE\n");
+    printf("static const int thermo_ntc[%d] = {", entries);
+    for (i = 0; i < entries; i++)
+	printf("%s%5d%s", i & 7 ? " " : "\n    ", table[i],
+	       i == entries - 1 ? "\n};\n" : ",");
+    printf("#endif\n");
+    return 0;
+}
+
+/******************************************************************************
+ *
+ *  Temperature for ADC reading
+ *  in: ADC value (may be fractional)
+ *  out: C, or HUGE_VAL/-HUGE_VAL past the ends
+ */
+
+static double adc_temp(double adc)
+{
+    double	v, r;
+
+    v = adc * vref / (ADC_COUNTS * vsup);	/* fraction of vsup */
+    if (v <= 0)
+	return HUGE_VAL;
+    if (v >= 1)
+	return -HUGE_VAL;
+    r = rdiv * v / (1 - v);
+    return 1 / (1 / (25 + KELVIN) + log(r / r25) / beta) - KELVIN;
+}
+
+/******************************************************************************
+ *
+ *  Table entry for ADC reading
+ *  in: ADC value
+ *  out: tenths C, rounded and held to TEMP_MIN and TEMP_MAX
+ */
+
+static int table_temp(int adc)
+{
+    double	temp;
+
+    temp = adc_temp(adc) * 10;
+    if (temp < TEMP_MIN)
+	return TEMP_MIN;
+    if (temp > TEMP_MAX)
+	return TEMP_MAX;
+    return lround(temp);
+}
+
+/******************************************************************************
+ *
+ *  Print worst lookup error for each 10 C, as lib_thermo interpolates
+ *  in: table
+ */
+
+static void put_errors(const int *table)
+{
+    double	worst[(TEMP_MAX - TEMP_MIN) / 100];
+    double	want, err;
+    int		adc, got, band, col;
+
+    for (band = 0; band < (TEMP_MAX - TEMP_MIN) / 100; band++)
+	worst[band] = -1;
+    for (adc = 0; adc < ADC_COUNTS; adc++) {
+	want = adc_temp(adc);
+	if (want * 10 < TEMP_MIN || want * 10 >= TEMP_MAX)
+	    continue;
+	got = table[adc >> shift] -
+	    (((table[adc >> shift] - table[(adc >> shift) + 1]) *
+	      (adc & ((1 << shift) - 1))) >> shift);
+	err = fabs(got / 10.0 - want);
+	band = (int)(want * 10 - TEMP_MIN) / 100;
+	if (err > worst[band])
+	    worst[band] = err;
+    }
+    col = 0;
+    for (band = 0; band < (TEMP_MAX - TEMP_MIN) / 100; band++) {
+	if (worst[band] < 0)
+	    continue;			/* no readings this hot or cold */
+	printf("%s%4d:%5.2f", col ? "  " : " * ",
+	       (TEMP_MIN / 10) + band * 10, worst[band]);
+	if (++col == 5) {
+	    printf("\n");
+	    col = 0;
+	}
+    }
+    if (col)
+	printf("\n");
+}
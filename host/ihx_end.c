@@ -0,0 +1,74 @@
+/*
+ *  File name:  ihx_end.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Check that a linked program ends below a flash address.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by the Makefile and run after linking the tests that
+ *  write flash past their own code:
+ *
+ *	ihx_end file.ihx limit
+ *
+ *  Finds the end of the data in flash (0x8000 up) in the Intel hex file,
+ *  and fails if it is past the limit, so the test area would overwrite
+ *  the program.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FLASH_START	0x8000
+
+/******************************************************************************
+ *
+ *  Find program end and compare
+ */
+
+int main(int argc, char **argv)
+{
+    char	line[600];
+    unsigned long upper, addr, end, limit;
+    unsigned int count, offset, type;
+    FILE	*file;
+
+    if (argc < 3) {
+	fprintf(stderr, "usage: %s file.ihx limit\n", argv[0]);
+	return 2;
+    }
+    limit = strtoul(argv[2], NULL, 0);
+    file = fopen(argv[1], "r");
+    if (!file) {
+	perror(argv[1]);
+	return 2;
+    }
+
+    upper = 0;
+    end = FLASH_START;
+    while (fgets(line, sizeof(line), file)) {
+	if (sscanf(line, ":%2x%4x%2x", &count, &offset, &type) != 3)
+	    continue;
+	if (type == 4)			/* extended linear address */
+	    sscanf(line + 9, "%4lx", &upper);
+	if (type != 0)
+	    continue;
+	addr = (upper << 16) + offset;
+	if (addr >= FLASH_START && addr + count > end)
+	    end = addr + count;
+    }
+    fclose(file);
+
+    printf("%s: code ends at 0x%04lx, limit 0x%04lx\n", argv[1], end, limit);
+    if (end <= limit)
+	return 0;
+    fprintf(stderr, "%s: program reaches the flash test area, "
+	    "raise FREE_BASE in the Makefile\n", argv[1]);
+    return 1;
+}
@@ -0,0 +1,22 @@
+/*
+ *  File name:  lib_flash.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host stand-in for lib_flash, for the host tests.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Same calls as the real lib_flash in ../libs. The host test that
+ *  links a module using it provides the functions, on a RAM array.
+ */
+
+void flash_init(void);
+char flash_unlock(void);
+void flash_lock(void);
+void flash_clear(char *, int);
@@ -0,0 +1,206 @@
+/*
+ *  File name:  send_update.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Send a binary image to lib_update over a serial port.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host/send_update" and run on Linux.
+ *
+ *	send_update device file address [block size]
+ *
+ *  The image is sent in frames of one block (64, or 128 for the STM8105),
+ *  the last one padded with zeros (erased flash). Each frame waits for
+ *  ACK, and is sent again on NAK or after FRAME_WAIT msecs. Other bytes
+ *  from the board (its messages) are ignored. At the end, the time and
+ *  bytes per second are printed.
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../lib_crc.h"
+
+#define UPD_SOH		0x01
+#define UPD_ACK		0x06
+#define UPD_NAK		0x15
+
+#define MAX_BLOCK	128
+#define FRAME_WAIT	500	/* msecs for answer */
+#define TRIES		10	/* sends of one frame */
+
+static int port_open(const char *);
+static int send_frame(int, unsigned int, const char *, int);
+static double now(void);
+
+/******************************************************************************
+ *
+ *  Send image file
+ */
+
+int main(int argc, char **argv)
+{
+    static char	image[0x10000];
+    double	start, secs;
+    unsigned int addr;
+    int		fd, len, block, pos, naks, retval;
+    FILE	*file;
+
+    if (argc < 4) {
+	fprintf(stderr, "usage: %s device file address [block size]\n",
+		argv[0]);
+	return 2;
+    }
+    addr = strtoul(argv[3], NULL, 0);
+    block = argc > 4 ? atoi(argv[4]) : 64;
+    if (block < 1 || block > MAX_BLOCK || addr % block) {
+	fprintf(stderr, "bad block size or address\n");
+	return 2;
+    }
+    file = fopen(argv[2], "rb");
+    if (!file) {
+	perror(argv[2]);
+	return 1;
+    }
+    len = fread(image, 1, sizeof(image), file);
+    fclose(file);
+    if (addr + len > 0x10000) {
+	fprintf(stderr, "image does not fit at 0x%04x\n", addr);
+	return 1;
+    }
+    fd = port_open(argv[1]);
+    if (fd < 0)
+	return 1;
+
+    naks = 0;
+    start = now();
+    for (pos = 0; pos < len; pos += block) {
+	retval = send_frame(fd, addr + pos, image + pos, block);
+	if (retval < 0) {
+	    fprintf(stderr, "\nno ACK for block at 0x%04x\n", addr + pos);
+	    return 1;
+	}
+	naks += retval;
+	printf("\r0x%04x", addr + pos);
+	fflush(stdout);
+    }
+    if (send_frame(fd, 0, NULL, 0) < 0) {
+	fprintf(stderr, "\nno ACK for end frame\n");
+	return 1;
+    }
+    secs = now() - start;
+    printf("\r%d bytes in %.2f secs, %.0f bytes/sec, %d resends\n",
+	   len, secs, len / secs, naks);
+    close(fd);
+    return 0;
+}
+
+/******************************************************************************
+ *
+ *  Open serial port at 115200, raw
+ *  in: device name
+ *  out: file descriptor, or -1
+ */
+
+static int port_open(const char *name)
+{
+    struct termios tio;
+    int		fd;
+
+    fd = open(name, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+	perror(name);
+	return -1;
+    }
+    if (tcgetattr(fd, &tio)) {
+	perror(name);
+	close(fd);
+	return -1;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B115200);
+    cfsetospeed(&tio, B115200);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    tcsetattr(fd, TCSANOW, &tio);
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+/******************************************************************************
+ *
+ *  Send frame until ACK
+ *  in: port, address, data, count (0 for end frame)
+ *  out: number of resends, or -1 if never answered
+ */
+
+static int send_frame(int fd, unsigned int addr, const char *data, int count)
+{
+    char	frame[MAX_BLOCK + 6];
+    struct pollfd pfd;
+    uint16_t	crc;
+    double	limit;
+    int		tries, wait;
+    char	c;
+
+    frame[0] = UPD_SOH;
+    frame[1] = addr >> 8;
+    frame[2] = addr;
+    frame[3] = count;
+    if (count)
+	memcpy(frame + 4, data, count);
+    crc = crc16_update(CRC16_INIT, frame + 1, count + 3);
+    frame[count + 4] = crc >> 8;
+    frame[count + 5] = crc;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    for (tries = 0; tries < TRIES; tries++) {
+	tcflush(fd, TCIFLUSH);	/* drop late answer to last send */
+	if (write(fd, frame, count + 6) != count + 6) {
+	    perror("write");
+	    return -1;
+	}
+	limit = now() + FRAME_WAIT / 1000.0;
+	for (;;) {
+	    wait = (limit - now()) * 1000;
+	    if (wait <= 0 || poll(&pfd, 1, wait) <= 0)
+		break;		/* no answer, send again */
+	    if (read(fd, &c, 1) != 1)
+		continue;
+	    if (c == UPD_ACK)
+		return tries;
+	    if (c == UPD_NAK)
+		break;
+	}
+    }
+    return -1;
+}
+
+/******************************************************************************
+ *
+ *  Time in seconds
+ */
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
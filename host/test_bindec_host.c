@@ -0,0 +1,240 @@
+/*
+ *  File name:  test_bindec_host.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host test of lib_fastdec against the C library.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host-test" and run on Linux.
+ *
+ * 1: bin16_dec_fast (all 16 bit values, snprintf and strtol)
+ * 2: bin8_dec2_fast (0-255, snprintf)
+ * 3: bin8_hex_fast  (0-255, snprintf and strtol)
+ * 4: bin32_dec_fast (all 32 bit values, split across all cores)
+ *
+ * For test 4, each thread keeps a decimal string that it increments
+ * like an odometer. The string is checked against snprintf and strtoul
+ * every SYNC_MASK+1 values. The full range takes a few minutes on one
+ * core and scales down with more cores.
+ *
+ * Every mismatch is printed. Exit status is 1 if there were any.
+ *
+ * Usage: test_bindec_host [threads]
+ *
+ * (lib_bindec itself is STM8 code in ../libs, so it is checked
+ * on the board by test_bindec.c instead.)
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../lib_fastdec.h"
+
+#define SYNC_MASK	0xfff	/* check odometer every 4096 values */
+#define MAX_THREADS	256
+
+typedef struct {
+    uint64_t	first;		/* first value to test */
+    uint64_t	end;		/* one past last value */
+    uint64_t	errors;
+} CHUNK;
+
+static pthread_mutex_t print_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void mismatch(const char *, unsigned long, const char *, const char *);
+static uint64_t test_1(void);
+static uint64_t test_2(void);
+static uint64_t test_3(void);
+static uint64_t test_4(int);
+static void *test_4_chunk(void *);
+
+/******************************************************************************
+ *
+ *  Run all tests and report
+ */
+
+int main(int argc, char **argv)
+{
+    uint64_t	errors;
+    int		threads;
+
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 1)
+	threads = atoi(argv[1]);
+    if (threads < 1)
+	threads = 1;
+    if (threads > MAX_THREADS)
+	threads = MAX_THREADS;
+
+    errors  = test_1();
+    errors += test_2();
+    errors += test_3();
+    errors += test_4(threads);
+
+    printf("%s: %llu mismatches\n", errors ? "FAIL" : "PASS",
+	   (unsigned long long)errors);
+    return errors ? 1 : 0;
+}
+
+/******************************************************************************
+ *
+ *  Print one mismatch
+ *  in: routine, value, result, expected
+ */
+
+static void mismatch(const char *name, unsigned long val,
+		     const char *got, const char *want)
+{
+    pthread_mutex_lock(&print_lock);
+    printf("%s(%lu): got \"%s\" want \"%s\"\n", name, val, got, want);
+    pthread_mutex_unlock(&print_lock);
+}
+
+/******************************************************************************
+ *
+ *  Test bin16_dec_fast
+ */
+
+static uint64_t test_1(void)
+{
+    uint64_t	errors;
+    uint32_t	val;
+    char	got[6], want[6];
+
+    errors = 0;
+    for (val = 0; val < 0x10000; val++) {
+	bin16_dec_fast(val, got);
+	snprintf(want, sizeof(want), "%05u", (unsigned)val);
+	if (strcmp(got, want) || strtol(got, NULL, 10) != (long)val) {
+	    mismatch("bin16_dec_fast", val, got, want);
+	    errors++;
+	}
+    }
+    printf("1: bin16_dec_fast done\n");
+    return errors;
+}
+
+/******************************************************************************
+ *
+ *  Test bin8_dec2_fast
+ */
+
+static uint64_t test_2(void)
+{
+    uint64_t	errors;
+    int		val;
+    char	got[3], want[3];
+
+    errors = 0;
+    for (val = 0; val < 256; val++) {
+	bin8_dec2_fast(val, got);
+	snprintf(want, sizeof(want), "%02d", val % 100);
+	if (strcmp(got, want)) {
+	    mismatch("bin8_dec2_fast", val, got, want);
+	    errors++;
+	}
+    }
+    printf("2: bin8_dec2_fast done\n");
+    return errors;
+}
+
+/******************************************************************************
+ *
+ *  Test bin8_hex_fast
+ */
+
+static uint64_t test_3(void)
+{
+    uint64_t	errors;
+    int		val;
+    char	got[3], want[3];
+
+    errors = 0;
+    for (val = 0; val < 256; val++) {
+	bin8_hex_fast(val, got);
+	snprintf(want, sizeof(want), "%02X", val);
+	if (strcmp(got, want) || strtol(got, NULL, 16) != val) {
+	    mismatch("bin8_hex_fast", val, got, want);
+	    errors++;
+	}
+    }
+    printf("3: bin8_hex_fast done\n");
+    return errors;
+}
+
+/******************************************************************************
+ *
+ *  Test bin32_dec_fast over the full range
+ *  in: thread count
+ */
+
+static uint64_t test_4(int threads)
+{
+    pthread_t	tid[MAX_THREADS];
+    CHUNK	chunk[MAX_THREADS];
+    uint64_t	errors, size;
+    int		i;
+
+    size = (0x100000000ULL + threads - 1) / threads;
+    for (i = 0; i < threads; i++) {
+	chunk[i].first = size * i;
+	chunk[i].end = size * (i + 1);
+	if (chunk[i].end > 0x100000000ULL)
+	    chunk[i].end = 0x100000000ULL;
+	chunk[i].errors = 0;
+	pthread_create(&tid[i], NULL, test_4_chunk, &chunk[i]);
+    }
+    errors = 0;
+    for (i = 0; i < threads; i++) {
+	pthread_join(tid[i], NULL);
+	errors += chunk[i].errors;
+    }
+    printf("4: bin32_dec_fast done (%d threads)\n", threads);
+    return errors;
+}
+
+static void *test_4_chunk(void *arg)
+{
+    CHUNK	*chunk;
+    uint64_t	val;
+    char	got[11], want[21], check[21];
+    int		i;
+
+    chunk = arg;
+    snprintf(want, sizeof(want), "%010llu", (unsigned long long)chunk->first);
+
+    for (val = chunk->first; val < chunk->end; val++) {
+	bin32_dec_fast(val, got);
+	if (memcmp(got, want, 11)) {
+	    mismatch("bin32_dec_fast", val, got, want);
+	    chunk->errors++;
+	}
+	if (!(val & SYNC_MASK)) {
+	    snprintf(check, sizeof(check), "%010llu", (unsigned long long)val);
+	    if (strcmp(want, check) || strtoul(got, NULL, 10) != val) {
+		mismatch("bin32_dec_fast", val, got, check);
+		chunk->errors++;
+		strcpy(want, check);
+	    }
+	}
+	for (i = 9; i >= 0; i--) {	/* odometer increment */
+	    if (want[i] != '9') {
+		want[i]++;
+		break;
+	    }
+	    want[i] = '0';
+	}
+    }
+    return NULL;
+}
@@ -0,0 +1,135 @@
+/*
+ *  File name:  test_crc_host.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host test of lib_crc against bit-at-a-time CRCs.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host-test" and run on Linux.
+ *
+ * 1: check values for "123456789"
+ * 2: random buffers of every length 0-300, in one piece and in random
+ *    pieces, against the bit-at-a-time definitions
+ *
+ * Every mismatch is printed. Exit status is 1 if there were any.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../lib_crc.h"
+
+#define MAX_LEN		300
+
+static unsigned long errors;
+
+static uint16_t crc16_bits(const unsigned char *, int);
+static uint32_t crc32_bits(const unsigned char *, int);
+static void check(const char *, int, uint32_t, uint32_t);
+
+/******************************************************************************
+ *
+ *  Run all tests and report
+ */
+
+int main(void)
+{
+    unsigned char buf[MAX_LEN];
+    uint32_t	crc32;
+    uint16_t	crc16;
+    int		len, pos, piece, i;
+
+    check("crc16 check", 9,
+	  crc16_update(CRC16_INIT, "123456789", 9), 0x29b1);
+    check("crc32 check", 9,
+	  CRC32_FINAL(crc32_update(CRC32_INIT, "123456789", 9)), 0xcbf43926);
+    printf("1: check values done\n");
+
+    srand(1);
+    for (len = 0; len <= MAX_LEN; len++) {
+	for (i = 0; i < len; i++)
+	    buf[i] = rand();
+	check("crc16", len, crc16_update(CRC16_INIT, (char *)buf, len),
+	      crc16_bits(buf, len));
+	check("crc32", len,
+	      CRC32_FINAL(crc32_update(CRC32_INIT, (char *)buf, len)),
+	      crc32_bits(buf, len));
+
+	crc16 = CRC16_INIT;
+	crc32 = CRC32_INIT;
+	for (pos = 0; pos < len; pos += piece) {
+	    piece = 1 + rand() % 17;
+	    if (piece > len - pos)
+		piece = len - pos;
+	    crc16 = crc16_update(crc16, (char *)buf + pos, piece);
+	    crc32 = crc32_update(crc32, (char *)buf + pos, piece);
+	}
+	check("crc16 pieces", len, crc16, crc16_bits(buf, len));
+	check("crc32 pieces", len, CRC32_FINAL(crc32), crc32_bits(buf, len));
+    }
+    printf("2: random buffers done\n");
+
+    printf("%s: %lu mismatches\n", errors ? "FAIL" : "PASS", errors);
+    return errors ? 1 : 0;
+}
+
+/******************************************************************************
+ *
+ *  CRC-16/CCITT-FALSE, one bit at a time
+ */
+
+static uint16_t crc16_bits(const unsigned char *buf, int len)
+{
+    uint16_t	crc;
+    int		bit;
+
+    crc = 0xffff;
+    while (len--) {
+	crc ^= *buf++ << 8;
+	for (bit = 0; bit < 8; bit++)
+	    crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+/******************************************************************************
+ *
+ *  CRC-32, one bit at a time
+ */
+
+static uint32_t crc32_bits(const unsigned char *buf, int len)
+{
+    uint32_t	crc;
+    int		bit;
+
+    crc = 0xffffffff;
+    while (len--) {
+	crc ^= *buf++;
+	for (bit = 0; bit < 8; bit++)
+	    crc = crc & 1 ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+    }
+    return crc ^ 0xffffffff;
+}
+
+/******************************************************************************
+ *
+ *  Compare result, print mismatch
+ *  in: test name, length, result, expected
+ */
+
+static void check(const char *name, int len, uint32_t got, uint32_t want)
+{
+    if (got == want)
+	return;
+    printf("%s(%d): got %08lx want %08lx\n", name, len,
+	   (unsigned long)got, (unsigned long)want);
+    errors++;
+}
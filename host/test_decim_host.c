@@ -0,0 +1,151 @@
+/*
+ *  File name:  test_decim_host.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host test of lib_decim.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host-test" (with unsigned char, like SDCC)
+ *  and run on Linux.
+ *
+ * 1: steady input, every 10 bit value and each bit count: result is
+ *    the input shifted left, DECIM_NONE before the first block, and
+ *    fresh is set only at the end of each block
+ * 2: largest 12 bit input with 4 bits does not overflow
+ * 3: noisy input between counts: the RMS error of the result from the
+ *    true level is at most NOISY_GAIN times that of the samples, over
+ *    2^bits (the square root of the number of samples)
+ *
+ * Every mismatch is printed. Exit status is 1 if there were any.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../lib_decim.h"
+
+#define NOISE		4	/* +/- counts */
+#define NOISY_RUNS	2000
+#define NOISY_GAIN	1.2
+
+static unsigned long errors;
+
+static void test_steady(void);
+static void test_noisy(char);
+static void fail(const char *);
+
+/******************************************************************************
+ *
+ *  Run all tests and report
+ */
+
+int main(void)
+{
+    DECIM	d;
+    int		i;
+    char	bits;
+
+    srand(1);
+
+    test_steady();
+    printf("1: steady done\n");
+
+    decim_init(&d, 4);
+    for (i = 0; i < 256; i++)
+	decim_add(&d, 4095);
+    if (decim_read(&d) != 65520)
+	fail("12 bit: overflow");
+    printf("2: 12 bit done\n");
+
+    for (bits = DECIM_BITS_MIN; bits <= DECIM_BITS_MAX; bits++)
+	test_noisy(bits);
+    printf("3: noisy done\n");
+
+    printf("%s: %lu mismatches\n", errors ? "FAIL" : "PASS", errors);
+    return errors ? 1 : 0;
+}
+
+/******************************************************************************
+ *
+ *  Steady input
+ */
+
+static void test_steady(void)
+{
+    DECIM	d;
+    uint16_t	val;
+    int		i, n;
+    char	bits;
+
+    for (bits = DECIM_BITS_MIN; bits <= DECIM_BITS_MAX; bits++) {
+	n = 1 << (bits * 2);
+	for (val = 0; val < 1024; val++) {
+	    decim_init(&d, bits);
+	    for (i = 1; i < n; i++) {
+		decim_add(&d, val);
+		if (d.fresh || decim_read(&d) != DECIM_NONE)
+		    fail("steady: result too soon");
+	    }
+	    decim_add(&d, val);
+	    if (!d.fresh || decim_read(&d) != val << bits)
+		fail("steady: wrong result");
+	    d.fresh = 0;
+	    for (i = 1; i < n; i++)
+		decim_add(&d, val + 1);
+	    if (d.fresh || decim_read(&d) != val << bits)
+		fail("steady: second result too soon");
+	    decim_add(&d, val + 1);
+	    if (!d.fresh || decim_read(&d) != (val + 1) << bits)
+		fail("steady: wrong second result");
+	}
+    }
+}
+
+/******************************************************************************
+ *
+ *  Noisy input around a level between counts
+ *  in: extra bits
+ */
+
+static void test_noisy(char bits)
+{
+    DECIM	d;
+    double	level, got, in_sq, out_sq, in_rms, out_rms;
+    int		run, i, n, sample;
+
+    n = 1 << (bits * 2);
+    in_sq = 0;
+    out_sq = 0;
+    for (run = 0; run < NOISY_RUNS; run++) {
+	level = 100 + (rand() % 80000) / 100.0;
+	decim_init(&d, bits);
+	for (i = 0; i < n; i++) {
+	    sample = level + (rand() % (NOISE * 200 + 1)) / 100.0 - NOISE + 0.5;
+	    in_sq += (sample - level) * (sample - level);
+	    decim_add(&d, sample);
+	}
+	got = (double)decim_read(&d) / (1 << bits);
+	out_sq += (got - level) * (got - level);
+    }
+    in_rms = sqrt(in_sq / ((double)NOISY_RUNS * n));
+    out_rms = sqrt(out_sq / NOISY_RUNS);
+    printf("   %d bits: RMS error %.3f counts, samples %.3f\n",
+	   bits, out_rms, in_rms);
+    if (out_rms > NOISY_GAIN * in_rms / (1 << bits))
+	fail("noisy: result not quieter than samples");
+}
+
+static void fail(const char *why)
+{
+    printf("%s\n", why);
+    errors++;
+}
@@ -0,0 +1,95 @@
+/*
+ *  File name:  test_format_host.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host test of lib_format against snprintf.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host-test" and run on Linux.
+ *
+ * 1: %u %5u %05u over all 16 bit values
+ * 2: %d %6d %06d over all 16 bit values
+ * 3: %lu %10lu over a prime step through 32 bits
+ * 4: mixed line formats used by the test programs
+ *
+ * Every mismatch is printed. Exit status is 1 if there were any.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib_format.h"
+
+static unsigned long errors;
+
+static void check(const char *, const char *, const char *);
+
+/******************************************************************************
+ *
+ *  Run all tests and report
+ */
+
+int main(void)
+{
+    char	got[64], want[64];
+    uint64_t	lval;
+    long	val;
+
+    for (val = 0; val < 0x10000; val++) {
+	fmt_line(got, "%u|%5u|%05u", (unsigned)val, (unsigned)val,
+		 (unsigned)val);
+	snprintf(want, sizeof(want), "%lu|%5lu|%05lu", val, val, val);
+	check("%u", got, want);
+    }
+    printf("1: unsigned done\n");
+
+    for (val = -32768; val < 32768; val++) {
+	fmt_line(got, "%d|%6d|%06d", (int)val, (int)val, (int)val);
+	snprintf(want, sizeof(want), "%ld|%6ld|%06ld", val, val, val);
+	check("%d", got, want);
+    }
+    printf("2: signed done\n");
+
+    for (lval = 0; lval < 0x100000000ULL; lval += 65521) {
+	fmt_line(got, "%lu|%10lu", (unsigned long)lval, (unsigned long)lval);
+	snprintf(want, sizeof(want), "%lu|%10lu", (unsigned long)lval,
+		 (unsigned long)lval);
+	check("%lu", got, want);
+    }
+    printf("3: long done\n");
+
+    fmt_line(got, "%5u inches ", 123);
+    check("inches", got, "  123 inches ");
+    fmt_line(got, "%u.%02uC", 21, 5);
+    check("celsius", got, "21.05C");
+    fmt_line(got, "%02u%c%02u%c%02u", 9, '-', 5, '-', 0);
+    check("clock", got, "09-05-00");
+    fmt_line(got, "%x %s %c%%", 0xa5, "hex", 'z');
+    check("misc", got, "A5 hex z%");
+    printf("4: lines done\n");
+
+    printf("%s: %lu mismatches\n", errors ? "FAIL" : "PASS", errors);
+    return errors ? 1 : 0;
+}
+
+/******************************************************************************
+ *
+ *  Compare result, print mismatch
+ *  in: test name, result, expected
+ */
+
+static void check(const char *name, const char *got, const char *want)
+{
+    if (!strcmp(got, want))
+	return;
+    printf("%s: got \"%s\" want \"%s\"\n", name, got, want);
+    errors++;
+}
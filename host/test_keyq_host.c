@@ -0,0 +1,275 @@
+/*
+ *  File name:  test_keyq_host.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host test of lib_keyq with scripted key presses.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host-test" (with unsigned char, like SDCC)
+ *  and run on Linux.
+ *
+ * 1: press and release: one event each, with the right times and keys,
+ *    then the same with a new key map
+ * 2: long press and repeat, stopped by release
+ * 3: chord: two keys down gives KEYQ_CHORD, and no long press
+ * 4: long press with no repeat
+ * 5: slow reader: the ring fills, later events are counted lost, and
+ *    the ones kept are in order
+ * 6: random key traffic, read a little at a time: every press has a
+ *    release, in order, with times that never go back
+ *
+ * Every mismatch is printed. Exit status is 1 if there were any.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../lib_keyq.h"
+
+#define LONG_MS		500
+#define REPEAT_MS	100
+#define RANDOM_MS	200000
+
+static const char map[] = "0123456789ABCDEF";
+
+static unsigned long errors;
+
+static void test_press(void);
+static void test_long(void);
+static void test_chord(void);
+static void test_no_repeat(void);
+static void test_full(void);
+static void test_random(void);
+static void run(uint16_t, int);
+static void expect(char, char, uint16_t, uint16_t, const char *);
+static void expect_none(const char *);
+static void fail(const char *);
+
+/******************************************************************************
+ *
+ *  Run all tests and report
+ */
+
+int main(void)
+{
+    test_press();
+    printf("1: press done\n");
+    test_long();
+    printf("2: long and repeat done\n");
+    test_chord();
+    printf("3: chord done\n");
+    test_no_repeat();
+    printf("4: long only done\n");
+    test_full();
+    printf("5: full ring done\n");
+    test_random();
+    printf("6: random done\n");
+
+    printf("%s: %lu mismatches\n", errors ? "FAIL" : "PASS", errors);
+    return errors ? 1 : 0;
+}
+
+/******************************************************************************
+ *
+ *  Press and release
+ */
+
+static void test_press(void)
+{
+    keyq_init(map, LONG_MS, REPEAT_MS);
+    run(0, 10);
+    run(0x0004, 100);			/* key 2 at 11 */
+    run(0, 10);				/* up at 111 */
+    expect(KEYQ_PRESS, '2', 11, 0x0004, "press");
+    expect(KEYQ_RELEASE, '2', 111, 0, "press");
+    expect_none("press");
+    if (keyq_now() != 120)
+	fail("press: wrong time");
+
+    keyq_kmap("abcdefgh");
+    run(0x0004, 1);			/* key 2 at 121 */
+    expect(KEYQ_PRESS, 'c', 121, 0x0004, "new map");
+    expect_none("new map");
+}
+
+/******************************************************************************
+ *
+ *  Long press and repeat
+ */
+
+static void test_long(void)
+{
+    int		i;
+
+    keyq_init(map, LONG_MS, REPEAT_MS);
+    run(0x8000, LONG_MS + 3 * REPEAT_MS);	/* key F at 1 */
+    run(0, 1);
+    expect(KEYQ_PRESS, 'F', 1, 0x8000, "long");
+    expect(KEYQ_LONG, 'F', 1 + LONG_MS, 0x8000, "long");
+    for (i = 1; i < 3; i++)
+	expect(KEYQ_REPEAT, 'F', 1 + LONG_MS + i * REPEAT_MS, 0x8000, "long");
+    expect(KEYQ_RELEASE, 'F', 1 + LONG_MS + 3 * REPEAT_MS, 0, "long");
+    expect_none("long");
+}
+
+/******************************************************************************
+ *
+ *  Two keys together
+ */
+
+static void test_chord(void)
+{
+    keyq_init(map, LONG_MS, REPEAT_MS);
+    run(0x0001, 10);			/* key 0 at 1 */
+    run(0x0003, LONG_MS * 2);		/* key 1 at 11 */
+    run(0x0002, LONG_MS - 1);		/* key 0 up, 1 still down */
+    run(0, 1);
+    expect(KEYQ_PRESS, '0', 1, 0x0001, "chord");
+    expect(KEYQ_PRESS, '1', 11, 0x0003, "chord");
+    expect(KEYQ_CHORD, '1', 11, 0x0003, "chord");
+    expect(KEYQ_RELEASE, '0', 11 + LONG_MS * 2, 0x0002, "chord");
+    expect(KEYQ_RELEASE, '1', 10 + LONG_MS * 3, 0, "chord");
+    expect_none("chord");
+}
+
+/******************************************************************************
+ *
+ *  Long press, no repeat
+ */
+
+static void test_no_repeat(void)
+{
+    keyq_init(map, LONG_MS, 0);
+    run(0x0010, LONG_MS * 4);
+    run(0, 1);
+    expect(KEYQ_PRESS, '4', 1, 0x0010, "long only");
+    expect(KEYQ_LONG, '4', 1 + LONG_MS, 0x0010, "long only");
+    expect(KEYQ_RELEASE, '4', 1 + LONG_MS * 4, 0, "long only");
+    expect_none("long only");
+}
+
+/******************************************************************************
+ *
+ *  Ring fills while nothing reads it
+ */
+
+static void test_full(void)
+{
+    int		i;
+
+    keyq_init(map, 0, 0);
+    for (i = 0; i < KEYQ_SIZE * 2; i++)	/* 2 events per key */
+	run(i & 1 ? 0 : 1 << (i / 2 & 15), 1);
+    if (keyq_lost != KEYQ_SIZE)
+	fail("full: wrong lost count");
+    for (i = 0; i < KEYQ_SIZE; i++)
+	expect(i & 1 ? KEYQ_RELEASE : KEYQ_PRESS, map[i / 2], i + 1,
+	       i & 1 ? 0 : 1 << (i / 2), "full");
+    expect_none("full");
+}
+
+/******************************************************************************
+ *
+ *  Random keys, reader takes a few events at a time
+ */
+
+static void test_random(void)
+{
+    KEYQ_EVENT	ev;
+    uint16_t	keys, down, last;
+    int		ms, n, bit;
+
+    srand(1);
+    keyq_init(map, LONG_MS, REPEAT_MS);
+    keys = 0;
+    down = 0;
+    last = 0;
+    for (ms = 0; ms < RANDOM_MS; ms++) {
+	if (!(rand() % 40))
+	    keys ^= 1 << (rand() % 16);
+	keyq_poll(keys);
+	for (n = rand() % 2; n && keyq_get(&ev); n--) {
+	    if ((uint16_t)(ev.time - last) > 0x8000)
+		fail("random: time went back");
+	    last = ev.time;
+	    bit = 1 << (ev.code <= '9' ? ev.code - '0' : ev.code - 'A' + 10);
+	    if (ev.type == KEYQ_PRESS) {
+		if (down & bit)
+		    fail("random: press of key down");
+		down |= bit;
+	    }
+	    if (ev.type == KEYQ_RELEASE) {
+		if (!(down & bit))
+		    fail("random: release of key up");
+		down &= ~bit;
+	    }
+	    if (ev.keys != down && ev.type <= KEYQ_RELEASE)
+		fail("random: keys do not match events");
+	}
+    }
+    if (keyq_lost)
+	fail("random: events lost");
+}
+
+/******************************************************************************
+ *
+ *  Poll with the same keys
+ *  in: keys, milliseconds
+ */
+
+static void run(uint16_t keys, int ms)
+{
+    while (ms--)
+	keyq_poll(keys);
+}
+
+/******************************************************************************
+ *
+ *  Check next event
+ *  in: type, code, time, keys, test name
+ */
+
+static void expect(char type, char code, uint16_t time, uint16_t keys,
+		   const char *name)
+{
+    KEYQ_EVENT	ev;
+    char	line[80];
+
+    if (!keyq_get(&ev)) {
+	snprintf(line, sizeof(line), "%s: no event, want type %d", name, type);
+	fail(line);
+	return;
+    }
+    if (ev.type == type && ev.code == code && ev.time == time &&
+	ev.keys == keys)
+	return;
+    snprintf(line, sizeof(line),
+	     "%s: got type %d '%c' %u %04x, want %d '%c' %u %04x", name,
+	     ev.type, ev.code, ev.time, ev.keys, type, code, time, keys);
+    fail(line);
+}
+
+static void expect_none(const char *name)
+{
+    KEYQ_EVENT	ev;
+    char	line[80];
+
+    if (!keyq_get(&ev))
+	return;
+    snprintf(line, sizeof(line), "%s: extra event type %d", name, ev.type);
+    fail(line);
+}
+
+static void fail(const char *why)
+{
+    printf("%s\n", why);
+    errors++;
+}
@@ -0,0 +1,231 @@
+/*
+ *  File name:  test_kvlog_host.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host test of lib_kvlog against a RAM model.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host-test" (with unsigned char, like SDCC)
+ *  and run on Linux. The "flash" is a RAM array, and a reboot is just
+ *  another kv_init() on it.
+ *
+ * 1: random puts and deletes through many compactions, with a reboot
+ *    and a full compare against the model after every put. The block
+ *    stand-in checks that compaction only writes whole aligned blocks,
+ *    in fast mode only to erased ones.
+ * 2: record without commit byte (power lost while writing it)
+ * 3: new area without its header (power lost while compacting)
+ * 4: errors: bad key, too long, full
+ *
+ * Every mismatch is printed. Exit status is 1 if there were any.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib_flash.h"
+#include "../lib_flashblk.h"
+#include "../lib_kvlog.h"
+
+#define AREA		640		/* bytes in each area, holds all keys */
+#define SMALL		128		/* area too small for all keys */
+#define PUTS		20000
+
+static char	flash[AREA * 2];
+static char	model[KV_KEYS + 1][KV_MAXLEN];
+static char	model_len[KV_KEYS + 1];
+static unsigned long errors;
+static unsigned long blocks;		/* block writes and erases */
+static int	unlocked;
+
+static void compare(const char *);
+static void fail(const char *, int);
+
+/******************************************************************************
+ *
+ *  lib_flash stand-in
+ */
+
+void flash_init(void)
+{
+}
+
+char flash_unlock(void)
+{
+    unlocked = 1;
+    return 0;
+}
+
+void flash_lock(void)
+{
+    unlocked = 0;
+}
+
+void flash_clear(char *ptr, int size)
+{
+    memset(ptr, 0, size);
+}
+
+/******************************************************************************
+ *
+ *  lib_flashblk stand-in
+ */
+
+void flashblk_init(void)
+{
+}
+
+char flashblk_write(char *dst, char *src, char mode)
+{
+    int		i;
+
+    if ((dst - flash) % FLASHBLK_SIZE)
+	return FLASHBLK_ALIGN;
+    if (unlocked)
+	fail("block write while unlocked", 0);
+    for (i = 0; mode == FLASHBLK_FAST && i < FLASHBLK_SIZE; i++)
+	if (dst[i]) {
+	    fail("fast write to block not erased", dst - flash);
+	    break;
+	}
+    memcpy(dst, src, FLASHBLK_SIZE);
+    blocks++;
+    return FLASHBLK_OK;
+}
+
+char flashblk_erase(char *dst)
+{
+    if ((dst - flash) % FLASHBLK_SIZE)
+	return FLASHBLK_ALIGN;
+    memset(dst, 0, FLASHBLK_SIZE);
+    blocks++;
+    return FLASHBLK_OK;
+}
+
+/******************************************************************************
+ *
+ *  Run all tests and report
+ */
+
+int main(void)
+{
+    char	data[KV_MAXLEN], *rec;
+    char	len, seq;
+    uint8_t	key;
+    int		i, j;
+
+    srand(1);
+    if (kv_init(flash, AREA) != 0)
+	fail("empty init", 0);
+
+    for (i = 0; i < PUTS; i++) {
+	key = 1 + rand() % KV_KEYS;
+	len = rand() % 4 ? rand() % 9 : rand() % (KV_MAXLEN + 1);
+	for (j = 0; j < len; j++)
+	    data[j] = rand();
+	if (kv_put(key, data, len) != KV_OK)
+	    fail("put", i);
+	memcpy(model[key], data, len);
+	model_len[key] = len;
+	if (unlocked)
+	    fail("left unlocked", i);
+	if (i % 16 == 0)
+	    kv_init(flash, AREA);	/* reboot */
+	compare("random");
+    }
+    printf("1: random done (area seq %d, %lu block cycles)\n", kv_seq(),
+	   blocks);
+
+    kv_put(1, (char *)"old", 3);
+    kv_compact();			/* room for the next record */
+    rec = flash + ((kv_seq() & 1) ? 0 : AREA);	/* area 0 has odd seq */
+    rec += AREA - kv_free();
+    kv_put(1, (char *)"new", 3);
+    rec[7] = 0;				/* no commit byte */
+    kv_init(flash, AREA);
+    len = kv_get(1, data, sizeof(data));
+    if (len != 3 || memcmp(data, "old", 3))
+	fail("torn record", 0);
+    kv_put(1, (char *)"two", 3);	/* append past torn record */
+    kv_init(flash, AREA);
+    len = kv_get(1, data, sizeof(data));
+    if (len != 3 || memcmp(data, "two", 3))
+	fail("after torn record", 0);
+    memcpy(model[1], "two", 3);
+    model_len[1] = 3;
+    compare("torn record");
+    printf("2: torn record done\n");
+
+    seq = kv_seq();
+    kv_compact();
+    flash[(seq & 1) ? AREA : 0] = 0;	/* lost 'K' of new header */
+    kv_init(flash, AREA);
+    if (kv_seq() != seq)
+	fail("torn compaction seq", seq);
+    compare("torn compaction");
+    kv_compact();
+    if ((char)(kv_seq() - seq) != 1)
+	fail("compaction after torn one", seq);
+    compare("compaction after torn one");
+    printf("3: torn compaction done\n");
+
+    if (kv_put(0, data, 1) != KV_BADKEY || kv_put(KV_KEYS + 1, data, 1)
+	!= KV_BADKEY)
+	fail("bad key", 0);
+    if (kv_put(1, data, KV_MAXLEN + 1) != KV_TOOBIG)
+	fail("too big", 0);
+    memset(flash, 0x55, sizeof(flash));	/* no valid header */
+    kv_init(flash, SMALL);
+    for (key = 1; key <= KV_KEYS; key++)
+	if (kv_put(key, data, KV_MAXLEN) != KV_OK)
+	    break;
+    if (key > KV_KEYS)
+	fail("full not reported", 0);
+    printf("4: errors done\n");
+
+    printf("%s: %lu mismatches\n", errors ? "FAIL" : "PASS", errors);
+    return errors ? 1 : 0;
+}
+
+/******************************************************************************
+ *
+ *  Compare every key with the model
+ *  in: test name
+ */
+
+static void compare(const char *name)
+{
+    char	data[KV_MAXLEN];
+    char	len;
+    uint8_t	key;
+
+    for (key = 1; key <= KV_KEYS; key++) {
+	len = kv_get(key, data, sizeof(data));
+	if (len != model_len[key] || memcmp(data, model[key], len)) {
+	    printf("%s: key %d length %d want %d\n", name, key, len,
+		   model_len[key]);
+	    errors++;
+	}
+    }
+}
+
+/******************************************************************************
+ *
+ *  Report failure
+ *  in: test name, value
+ */
+
+static void fail(const char *name, int val)
+{
+    printf("%s: failed at %d\n", name, val);
+    errors++;
+}
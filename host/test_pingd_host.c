@@ -0,0 +1,112 @@
+/*
+ *  File name:  test_pingd_host.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host test of lib_pingd against exact divides.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host-test" (with unsigned char, like SDCC)
+ *  and run on Linux.
+ *
+ * 1: the 20 C scales built in match pingd_temp(20)
+ * 2: every count 0-65534 at every temperature, in mm, cm and inches,
+ *    against the multiply-shift done in 64 bits (same scale), and
+ *    against the exact divide: result must be the exact distance
+ *    rounded down, or one less
+ *
+ * Every mismatch is printed (the first few of each kind). Exit status
+ * is 1 if there were any.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../lib_pingd.h"
+
+#define MAX_PRINT	10
+
+typedef struct {
+    const char	*name;
+    uint16_t	(*conv)(uint16_t);
+    int		shift;
+    uint64_t	div;		/* speed / div is units per count */
+} UNIT;
+
+static const UNIT units[] = {
+    { "mm",   pingd_mm,   19, 4000000 },
+    { "cm",   pingd_cm,   22, 40000000 },
+    { "inch", pingd_inch, 24, 101600000 },
+};
+
+static unsigned long errors;
+
+static void fail(const char *, int, unsigned, unsigned, unsigned long);
+
+/******************************************************************************
+ *
+ *  Run all tests and report
+ */
+
+int main(void)
+{
+    uint16_t	before[3][4];
+    uint64_t	speed, scale, exact, shifted;
+    unsigned	count, got;
+    int		temp, u, i;
+    unsigned long checks;
+
+    for (u = 0; u < 3; u++)
+	for (i = 0; i < 4; i++)
+	    before[u][i] = units[u].conv(i * 16383 + 1);
+    pingd_temp(20);
+    for (u = 0; u < 3; u++)
+	for (i = 0; i < 4; i++)
+	    if (units[u].conv(i * 16383 + 1) != before[u][i])
+		fail(units[u].name, 20, i * 16383 + 1,
+		     units[u].conv(i * 16383 + 1), before[u][i]);
+    printf("1: default scales done\n");
+
+    checks = 0;
+    for (temp = PINGD_TEMP_MIN; temp <= PINGD_TEMP_MAX; temp++) {
+	pingd_temp(temp);
+	speed = 331300 + 606 * temp;
+	for (u = 0; u < 3; u++) {
+	    scale = (speed << units[u].shift) / units[u].div;
+	    for (count = 0; count < 0xffff; count++) {
+		got = units[u].conv(count);
+		shifted = (count * scale) >> units[u].shift;
+		exact = count * speed / units[u].div;
+		if (got != shifted)
+		    fail(units[u].name, temp, count, got, shifted);
+		if (got > exact || got + 1 < exact)
+		    fail(units[u].name, temp, count, got, exact);
+		checks++;
+	    }
+	}
+    }
+    printf("2: %lu conversions done\n", checks);
+
+    printf("%s: %lu mismatches\n", errors ? "FAIL" : "PASS", errors);
+    return errors ? 1 : 0;
+}
+
+/******************************************************************************
+ *
+ *  Print mismatch
+ *  in: unit, temperature, count, result, expected
+ */
+
+static void fail(const char *name, int temp, unsigned count, unsigned got,
+		 unsigned long want)
+{
+    if (errors++ < MAX_PRINT)
+	printf("%s %d C count %u: got %u want %lu\n",
+	       name, temp, count, got, want);
+}
@@ -0,0 +1,259 @@
+/*
+ *  File name:  test_pingf_host.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host test of lib_pingf with echo traces.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host-test" (with unsigned char, like SDCC)
+ *  and run on Linux.
+ *
+ * 1: median only, random results, against qsort
+ * 2: tank trace: steady level with noise, false short echoes and missed
+ *    echoes. The filtered value must stay near the level.
+ * 3: step trace: level moves; the filter must follow within STEP_LAG
+ * 4: time per sample on this host (see BENCH_FILTER in test_ping.c
+ *    for STM8 cycles)
+ *
+ * A recorded trace (one result per line, -1 for no echo) can be given
+ * as an argument; it is replayed and each result printed with the
+ * filtered value, and the tests are not run.
+ *
+ * Every mismatch is printed. Exit status is 1 if there were any.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../lib_pingf.h"
+
+#define RANDOM_RUNS	200000
+#define TRACE_LEN	5000
+#define LEVEL		5920	/* usecs, 40 inches */
+#define NOISE		15	/* usecs either way */
+#define SHIFT		3
+#define JUMP		300	/* usecs, about 2 inches */
+#define STEP_LAG	24	/* samples to follow a step */
+#define BENCH_RUNS	10000000
+
+static unsigned long errors;
+
+static int replay(const char *);
+static void test_median(void);
+static void test_tank(void);
+static void test_step(void);
+static void bench(void);
+static uint16_t noisy(int);
+static int cmp_u16(const void *, const void *);
+
+/******************************************************************************
+ *
+ *  Run all tests and report, or replay a trace
+ */
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+	return replay(argv[1]);
+
+    srand(1);
+    test_median();
+    printf("1: median done\n");
+    test_tank();
+    printf("2: tank trace done\n");
+    test_step();
+    printf("3: step trace done\n");
+    bench();
+
+    printf("%s: %lu mismatches\n", errors ? "FAIL" : "PASS", errors);
+    return errors ? 1 : 0;
+}
+
+/******************************************************************************
+ *
+ *  Replay recorded trace
+ *  in: file name
+ */
+
+static int replay(const char *name)
+{
+    PINGF	filter;
+    FILE	*file;
+    long	val;
+    uint16_t	out;
+
+    file = fopen(name, "r");
+    if (!file) {
+	perror(name);
+	return 1;
+    }
+    pingf_init(&filter, SHIFT, JUMP);
+    while (fscanf(file, "%ld", &val) == 1) {
+	out = pingf_add(&filter, val < 0 ? PINGF_NONE : (uint16_t)val);
+	if (out == PINGF_NONE)
+	    printf("%ld -1\n", val);
+	else
+	    printf("%ld %u\n", val, out);
+    }
+    fclose(file);
+    return 0;
+}
+
+/******************************************************************************
+ *
+ *  With shift 0 and no outlier check, output is the plain median
+ */
+
+static void test_median(void)
+{
+    PINGF	filter;
+    uint16_t	hist[PINGF_MEDIAN], sort[PINGF_MEDIAN];
+    uint16_t	val, out, want;
+    int		i, n;
+
+    pingf_init(&filter, 0, 0xffff);
+    for (i = 0; i < RANDOM_RUNS; i++) {
+	val = rand() % 0xffff;		/* anything but PINGF_NONE */
+	if (i < PINGF_MEDIAN)
+	    n = i + 1;
+	else
+	    n = PINGF_MEDIAN;
+	hist[i % PINGF_MEDIAN] = val;
+	for (int j = 0; j < n; j++)
+	    sort[j] = hist[j];
+	qsort(sort, n, sizeof(uint16_t), cmp_u16);
+	want = sort[(n - 1) / 2];
+
+	out = pingf_add(&filter, val);
+	if (out != want) {
+	    printf("median %d: got %u want %u\n", i, out, want);
+	    errors++;
+	}
+    }
+}
+
+/******************************************************************************
+ *
+ *  Steady level: 8% false short echoes (some in pairs), 5% missing
+ */
+
+static void test_tank(void)
+{
+    PINGF	filter;
+    uint16_t	val, out;
+    int		i, worst, dev;
+
+    pingf_init(&filter, SHIFT, JUMP);
+    worst = 0;
+    for (i = 0; i < TRACE_LEN; i++) {
+	val = noisy(LEVEL);
+	if (rand() % 100 < 8)
+	    val = 600 + rand() % 2000;	/* echo off the tank wall */
+	if (rand() % 100 < 5)
+	    val = PINGF_NONE;
+	out = pingf_add(&filter, val);
+	if (i < PINGF_MEDIAN)
+	    continue;
+	if (out == PINGF_NONE) {
+	    printf("tank %d: no value\n", i);
+	    errors++;
+	    continue;
+	}
+	dev = abs((int)out - LEVEL);
+	if (dev > worst)
+	    worst = dev;
+    }
+    printf("   worst error %d usecs (noise %d)\n", worst, NOISE);
+    if (worst > NOISE * 2) {
+	printf("tank: error too big\n");
+	errors++;
+    }
+}
+
+/******************************************************************************
+ *
+ *  Level steps up and down, with false echoes
+ */
+
+static void test_step(void)
+{
+    static const uint16_t levels[] = { 5920, 3000, 3200, 12000, 800, 801 };
+    PINGF	filter;
+    uint16_t	val, out, level;
+    int		step, i, settled;
+
+    pingf_init(&filter, SHIFT, JUMP);
+    for (step = 0; step < sizeof(levels) / sizeof(levels[0]); step++) {
+	level = levels[step];
+	settled = -1;
+	for (i = 0; i < 200; i++) {
+	    val = noisy(level);
+	    if (rand() % 100 < 8)
+		val = 600 + rand() % 2000;
+	    out = pingf_add(&filter, val);
+	    if (settled < 0 && out != PINGF_NONE &&
+		abs((int)out - level) <= NOISE * 2)
+		settled = i;
+	    if (settled >= 0 && abs((int)out - level) > NOISE * 2) {
+		printf("step %u: left level at %d (%u)\n", level, i, out);
+		errors++;
+		break;
+	    }
+	}
+	printf("   step to %5u: settled in %d samples\n", level, settled);
+	if (settled < 0 || settled > STEP_LAG) {
+	    printf("step %u: too slow\n", level);
+	    errors++;
+	}
+    }
+}
+
+/******************************************************************************
+ *
+ *  Time per sample
+ */
+
+static void bench(void)
+{
+    static uint16_t trace[1024];
+    PINGF	filter;
+    struct timespec t0, t1;
+    volatile uint16_t sink;
+    double	ns;
+    int		i;
+
+    for (i = 0; i < 1024; i++)
+	trace[i] = rand() % 8 ? noisy(LEVEL) : 600 + rand() % 2000;
+    pingf_init(&filter, SHIFT, JUMP);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < BENCH_RUNS; i++)
+	sink = pingf_add(&filter, trace[i & 1023]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    (void)sink;
+    ns = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+    printf("4: %.1f ns per sample on host\n", ns / BENCH_RUNS);
+}
+
+/******************************************************************************
+ *
+ *  Level with noise
+ */
+
+static uint16_t noisy(int level)
+{
+    return level - NOISE + rand() % (NOISE * 2 + 1);
+}
+
+static int cmp_u16(const void *a, const void *b)
+{
+    return *(const uint16_t *)a - *(const uint16_t *)b;
+}
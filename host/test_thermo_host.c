@@ -0,0 +1,256 @@
+/*
+ *  File name:  test_thermo_host.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Host test of lib_thermo with a simulated oven.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Built natively by "make host-test" (with unsigned char, like SDCC)
+ *  and run on Linux.
+ *
+ * 1: thermo_temp() against the beta formula (with the NTC values from
+ *    thermo_lut.h), for every ADC value from -30 to 140 C (85 C with
+ *    steps over 8 counts, where the hot end is coarser), the table
+ *    entries exactly, and the probe fault ends
+ * 2: hysteresis, heating: settles in the band, relay minimum times kept
+ * 3: hysteresis, cooling
+ * 4: PID, heating: settles near the setpoint, minimum times kept
+ * 5: probe fault turns the relay off at once
+ * 6: thermo_temp16() matches thermo_temp() at whole counts, and never
+ *    goes up as the reading goes up
+ *
+ * The oven is one thermal mass with loss to the room, plus a lag in
+ * the probe. Ticks are 1/10 second.
+ *
+ * Every mismatch is printed. Exit status is 1 if there were any.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../lib_thermo.h"
+
+#define NTC_TABLE
+#include "../thermo_lut.h"
+
+#define BETA		((double)NTC_BETA)
+#define R25		((double)NTC_R25)
+#define R_PULL		((double)NTC_RDIV)
+#define V_RATIO		((double)NTC_VREF / NTC_VSUP)
+
+#define TABLE_LO	-30.0	/* table checked from here */
+#if NTC_SHIFT <= 3
+#define TABLE_HI	140.0	/*  to here (C) */
+#else
+#define TABLE_HI	85.0
+#endif
+#define TABLE_ERR	1.0	/*  with this error */
+#define TICKS		(10 * 3600)	/* one hour */
+#define SETTLE		(10 * 1200)	/* 20 minutes to settle */
+
+static unsigned long errors;
+
+typedef struct {
+    double	temp;		/* oven, C */
+    double	probe;		/* probe, C */
+    double	room;
+    double	power;		/* C per second when on, from room */
+    double	loss;		/* fraction per second to room */
+    double	lag;		/* fraction per second probe follows */
+} OVEN;
+
+static void test_table(void);
+static void test_temp16(void);
+static void run(const char *, THERMO *, OVEN *, double, double);
+static uint16_t adc_for(double);
+static void fail(const char *);
+
+/******************************************************************************
+ *
+ *  Run all tests and report
+ */
+
+int main(void)
+{
+    THERMO	t;
+    OVEN	oven;
+
+    test_table();
+    printf("1: table done\n");
+
+    t.mode = THERMO_HEAT | THERMO_HYST;
+    t.setpoint = 600;		/* 60.0 C */
+    t.hyst = 10;
+    t.min_on = 300;		/* 30 seconds */
+    t.min_off = 300;
+    thermo_reset(&t);
+    oven = (OVEN){ 20, 20, 20, 0.05, 0.0006, 0.1 };
+    run("hyst heat", &t, &oven, 59.0 - 1.5, 60.0 + 2.5);
+    printf("2: hysteresis heat done\n");
+
+    t.mode = THERMO_COOL | THERMO_HYST;
+    t.setpoint = 40;		/* 4.0 C */
+    t.min_on = 600;		/* compressor: 1 minute */
+    t.min_off = 1800;		/* 3 minutes */
+    thermo_reset(&t);
+    oven = (OVEN){ 20, 20, 20, -0.03, 0.001, 0.1 };
+    run("hyst cool", &t, &oven, 4.0 - 2.5, 5.0 + 2.5);
+    printf("3: hysteresis cool done\n");
+
+    t.mode = THERMO_HEAT | THERMO_PID;
+    t.setpoint = 600;
+    t.kp = 5120;		/* full on at 5 C low */
+    t.ki = 1;
+    t.kd = 10240;
+    t.window = 100;		/* 10 seconds */
+    t.min_on = 10;
+    t.min_off = 10;
+    thermo_reset(&t);
+    oven = (OVEN){ 20, 20, 20, 0.05, 0.0006, 0.1 };
+    run("pid heat", &t, &oven, 60.0 - 0.6, 60.0 + 0.6);
+    printf("4: PID heat done\n");
+
+    thermo_tick(&t, 590);
+    if (thermo_tick(&t, THERMO_FAULT) || t.relay)
+	fail("fault: relay not off");
+    printf("5: fault done\n");
+
+    test_temp16();
+    printf("6: 16 bit readings done\n");
+
+    printf("%s: %lu mismatches\n", errors ? "FAIL" : "PASS", errors);
+    return errors ? 1 : 0;
+}
+
+/******************************************************************************
+ *
+ *  Table against beta formula
+ */
+
+static void test_table(void)
+{
+    double	r, want, worst;
+    int		adc, got, at;
+
+    worst = 0;
+    at = 0;
+    for (adc = 0; adc < 1024; adc++) {
+	got = thermo_temp(adc);
+	if (adc < THERMO_ADC_MIN || adc > THERMO_ADC_MAX) {
+	    if (got != THERMO_FAULT)
+		fail("table: no fault at end");
+	    continue;
+	}
+	if (!(adc & ((1 << NTC_SHIFT) - 1)) &&
+	    got != thermo_ntc[adc >> NTC_SHIFT])
+	    fail("table: entry not exact");
+	r = R_PULL * adc * V_RATIO / (1024 - adc * V_RATIO);
+	want = 1 / (1 / 298.15 + log(r / R25) / BETA) - 273.15;
+	if (want < TABLE_LO || want > TABLE_HI)
+	    continue;
+	if (fabs(got / 10.0 - want) > worst) {
+	    worst = fabs(got / 10.0 - want);
+	    at = adc;
+	}
+    }
+    printf("   worst error %.2f C at ADC %d\n", worst, at);
+    if (worst > TABLE_ERR)
+	fail("table: error too big");
+}
+
+/******************************************************************************
+ *
+ *  16 bit readings against 10 bit
+ */
+
+static void test_temp16(void)
+{
+    long	adc;
+    int		got, last;
+
+    for (adc = 0; adc < 1024; adc++)
+	if (thermo_temp16(adc << 6) != thermo_temp(adc))
+	    fail("temp16: not same as temp");
+
+    last = THERMO_FAULT;
+    for (adc = THERMO_ADC_MIN << 6; adc < (THERMO_ADC_MAX + 1) << 6; adc++) {
+	got = thermo_temp16(adc);
+	if (got == THERMO_FAULT || (last != THERMO_FAULT && got > last))
+	    fail("temp16: not falling");
+	last = got;
+    }
+}
+
+/******************************************************************************
+ *
+ *  Run oven for an hour, check band after settling and relay times
+ *  in: name, thermostat, oven, band low and high (C)
+ */
+
+static void run(const char *name, THERMO *t, OVEN *oven, double lo, double hi)
+{
+    double	min, max;
+    int		tick, since, relay, last, switches;
+    char	line[80];
+
+    min = 1000;
+    max = -1000;
+    last = 0;
+    since = 0;
+    switches = 0;
+    for (tick = 0; tick < TICKS; tick++) {
+	relay = thermo_tick(t, thermo_temp(adc_for(oven->probe)));
+	since++;
+	if (relay != last) {
+	    if (tick && since < (last ? t->min_on : t->min_off)) {
+		snprintf(line, sizeof(line), "%s: relay %s after %d ticks",
+			 name, last ? "on" : "off", since);
+		fail(line);
+	    }
+	    since = 0;
+	    last = relay;
+	    switches++;
+	}
+	oven->temp += (relay * oven->power -
+		       (oven->temp - oven->room) * oven->loss) / 10;
+	oven->probe += (oven->temp - oven->probe) * oven->lag / 10;
+	if (tick < SETTLE)
+	    continue;
+	if (oven->temp < min)
+	    min = oven->temp;
+	if (oven->temp > max)
+	    max = oven->temp;
+    }
+    printf("   %s: %.2f to %.2f C, %d switches\n", name, min, max, switches);
+    if (min < lo || max > hi) {
+	snprintf(line, sizeof(line), "%s: outside %.1f to %.1f", name, lo, hi);
+	fail(line);
+    }
+}
+
+/******************************************************************************
+ *
+ *  ADC value for probe temperature
+ */
+
+static uint16_t adc_for(double temp)
+{
+    double	r;
+
+    r = R25 * exp(BETA * (1 / (temp + 273.15) - 1 / 298.15));
+    return 1024 * r / (r + R_PULL) / V_RATIO + 0.5;
+}
+
+static void fail(const char *why)
+{
+    printf("%s\n", why);
+    errors++;
+}
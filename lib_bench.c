@@ -0,0 +1,223 @@
+/*
+ *  File name:  lib_bench.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Cycle counter for benchmarks and simulator runs.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ */
+
+#include "stm8s_header.h"
+
+#include "lib_bench.h"
+#include "lib_bindec.h"
+#include "lib_uart.h"
+
+#ifdef STM8105
+#define BENCH_UART_SR	UART2_SR
+#define BENCH_MS_PSCR	(8000 - 1)	/* 8 mhz crystal */
+#else
+#define BENCH_UART_SR	UART1_SR
+#define BENCH_MS_PSCR	(16000 - 1)
+#endif
+
+static volatile uint16_t bench_high;	/* overflow count */
+static uint16_t bench_zero;		/* cycles for empty measurement */
+
+static void bench_start(uint16_t);
+static void bench_num(char *, uint16_t);
+
+/******************************************************************************
+ *
+ *  Start Timer 1 as free-running cycle counter
+ */
+
+void bench_init(void)
+{
+    bench_start(0);		/* count every CPU clock */
+    bench_zero = bench_read();
+    bench_zero = bench_read() - bench_zero;
+}
+
+/******************************************************************************
+ *
+ *  Start Timer 1 as free-running millisecond counter
+ */
+
+void bench_init_ms(void)
+{
+    bench_start(BENCH_MS_PSCR);
+    bench_zero = 0;
+}
+
+/******************************************************************************
+ *
+ *  Start Timer 1 from zero
+ *  in: prescaler (counts every prescaler + 1 CPU clocks)
+ */
+
+static void bench_start(uint16_t pscr)
+{
+    bench_high = 0;
+
+    TIM1_CR1   = 0;		/* stop timer */
+    TIM1_PSCRH = pscr >> 8;
+    TIM1_PSCRL = pscr;
+    TIM1_ARRH  = 0xff;		/* full 16 bit range */
+    TIM1_ARRL  = 0xff;
+    TIM1_EGR   = 1;		/* load prescaler now */
+    TIM1_SR1   = 0;		/* clear the update from EGR */
+    TIM1_IER   = 1;		/* interrupt on overflow */
+    TIM1_CR1   = 1;		/* start counting */
+}
+
+/******************************************************************************
+ *
+ *  Read low 16 bits of cycle counter
+ */
+
+uint16_t bench_read(void)
+{
+    uint16_t	count;
+
+    count = TIM1_CNTRH << 8;	/* reading high byte latches low byte */
+    count |= TIM1_CNTRL;
+    return count;
+}
+
+/******************************************************************************
+ *
+ *  Read full 32 bit cycle counter
+ */
+
+uint32_t bench_read32(void)
+{
+    uint16_t	high, low;
+
+    do {
+	high = bench_high;
+	low = bench_read();
+    } while (high != bench_high);	/* overflow between reads */
+
+    return ((uint32_t)high << 16) | low;
+}
+
+/******************************************************************************
+ *
+ *  Clear benchmark statistics
+ */
+
+void bench_clear(BENCH_STAT *stat)
+{
+    stat->min = 0xffff;
+    stat->max = 0;
+    stat->sum = 0;
+    stat->count = 0;
+}
+
+/******************************************************************************
+ *
+ *  Add one timing to statistics
+ *  in: statistics, cycles
+ */
+
+void bench_add(BENCH_STAT *stat, uint16_t cycles)
+{
+    if (cycles > bench_zero)
+	cycles -= bench_zero;
+    else
+	cycles = 0;
+
+    if (cycles < stat->min)
+	stat->min = cycles;
+    if (cycles > stat->max)
+	stat->max = cycles;
+    stat->sum += cycles;
+    stat->count++;
+}
+
+/******************************************************************************
+ *
+ *  Print statistics to UART
+ *  in: name, statistics
+ */
+
+void bench_print(char *name, BENCH_STAT *stat)
+{
+    uart_puts(name);
+    if (!stat->count) {
+	uart_puts(" no samples\r\n");
+	return;
+    }
+    bench_num(" min ", stat->min);
+    bench_num(" avg ", stat->sum / stat->count);
+    bench_num(" max ", stat->max);
+    uart_crlf();
+}
+
+static void bench_num(char *label, uint16_t val)
+{
+    char	decimal[6];
+
+    uart_puts(label);
+    bin16_dec(val, decimal);
+    uart_puts(decimal_rlz(decimal, 4));
+}
+
+/******************************************************************************
+ *
+ *  Print cycle count for test phase to UART
+ *  in: phase number, cycles
+ */
+
+void bench_phase(char phase, uint32_t cycles)
+{
+    char	decimal[11];
+
+    uart_puts("PHASE ");
+    bin8_dec2(phase, decimal);
+    uart_puts(decimal);
+    uart_puts(": ");
+    bin32_dec(cycles, decimal);
+    uart_puts(decimal_rlz(decimal, 9));
+    uart_puts(" cycles\r\n");
+}
+
+/******************************************************************************
+ *
+ *  End of benchmark run
+ */
+
+void bench_stop(void)
+{
+    int		idle;
+
+    idle = 0;
+    while (idle < 2000) {	/* TX idle for longer than one byte time */
+	idle++;
+	if (!(BENCH_UART_SR & 0x40))
+	    idle = 0;
+    }
+#ifdef SIM
+    *(volatile char *)SIM_IF = 's';	/* ucsim "stop" command */
+#endif
+    for (;;);
+}
+
+/******************************************************************************
+ *
+ *  Timer 1 overflow interrupt
+ */
+
+void bench_isr(void) __interrupt (IRQ_TIM1)
+{
+    TIM1_SR1 = 0;		/* clear the interrupt */
+    bench_high++;
+}
@@ -0,0 +1,121 @@
+/*
+ *  File name:  lib_bench.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Cycle counter for benchmarks and simulator runs.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Timer 1 runs free at the CPU clock, so each count is one cycle.
+ *  The overflow interrupt extends the count to 32 bits.
+ *  Do not combine with another library that uses Timer 1.
+ *
+ *  The overflow interrupt is missed if interrupts are off for longer
+ *  than one wrap (4 msec at 16 mhz), as they are for a flash write.
+ *  Time those with bench_init_ms(), which counts milliseconds instead.
+ *
+ *  Results are printed with lib_uart, so call uart_init() first.
+ *
+ *  When built with -DSIM, bench_stop() ends the ucsim simulator run
+ *  through the simulator interface at SIM_IF (see "make sim").
+ */
+
+#ifndef IRQ_TIM1
+#define IRQ_TIM1	11	/* Timer 1 update/overflow */
+#endif
+
+#define SIM_IF		0x5fff	/* Unused address for ucsim interface. */
+
+typedef struct {
+    uint16_t	min;		/* fewest cycles */
+    uint16_t	max;		/* most cycles */
+    uint32_t	sum;		/* total cycles */
+    uint32_t	count;		/* number of samples */
+} BENCH_STAT;
+
+/******************************************************************************
+ *
+ *  Start Timer 1 as free-running cycle counter
+ */
+
+void bench_init(void);
+
+/******************************************************************************
+ *
+ *  Start Timer 1 as free-running millisecond counter
+ *  (bench_read() and bench_read32() then give milliseconds.)
+ */
+
+void bench_init_ms(void);
+
+/******************************************************************************
+ *
+ *  Read low 16 bits of cycle counter
+ *  (Good for timing anything shorter than 4 milliseconds.)
+ */
+
+uint16_t bench_read(void);
+
+/******************************************************************************
+ *
+ *  Read full 32 bit cycle counter
+ *  (Interrupts must be enabled.)
+ */
+
+uint32_t bench_read32(void);
+
+/******************************************************************************
+ *
+ *  Clear benchmark statistics
+ *  in: statistics
+ */
+
+void bench_clear(BENCH_STAT *);
+
+/******************************************************************************
+ *
+ *  Add one timing to statistics
+ *  in: statistics, cycles from difference of two bench_read() calls
+ *  The cost of bench_read() itself is subtracted.
+ */
+
+void bench_add(BENCH_STAT *, uint16_t);
+
+/******************************************************************************
+ *
+ *  Print statistics to UART
+ *  in: name, statistics
+ *  out: "name min nnnnn avg nnnnn max nnnnn"
+ */
+
+void bench_print(char *, BENCH_STAT *);
+
+/******************************************************************************
+ *
+ *  Print cycle count for test phase to UART
+ *  in: phase number, cycles
+ *  out: "PHASE n: cccccccccc cycles"
+ */
+
+void bench_phase(char, uint32_t);
+
+/******************************************************************************
+ *
+ *  End of benchmark run
+ *  Wait for UART to finish, then stop the simulator (if SIM) or halt.
+ */
+
+void bench_stop(void);
+
+/******************************************************************************
+ *
+ *  Timer 1 overflow interrupt
+ */
+
+void bench_isr(void) __interrupt (IRQ_TIM1);
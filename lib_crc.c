@@ -0,0 +1,72 @@
+/*
+ *  File name:  lib_crc.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Streaming CRC-16/CCITT and CRC-32 with nibble tables.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Each byte is done as two 4 bit steps. For CRC-16 (MSB first), entry
+ *  n is the CRC of n in the top nibble. For CRC-32 (LSB first), entry n
+ *  is the reflected CRC of n in the bottom nibble.
+ */
+
+#include <stdint.h>
+
+#include "lib_crc.h"
+
+static const uint16_t crc16_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef
+};
+
+static const uint32_t crc32_table[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+    0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+    0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+};
+
+/******************************************************************************
+ *
+ *  Add bytes to CRC-16/CCITT
+ *  in: CRC so far, data, count
+ *  out: new CRC
+ */
+
+uint16_t crc16_update(uint16_t crc, const char *buf, int count)
+{
+    char	c;
+
+    while (count--) {
+	c = *buf++;
+	crc = (crc << 4) ^ crc16_table[(crc >> 12) ^ ((c >> 4) & 15)];
+	crc = (crc << 4) ^ crc16_table[(crc >> 12) ^ (c & 15)];
+    }
+    return crc;
+}
+
+/******************************************************************************
+ *
+ *  Add bytes to CRC-32
+ *  in: CRC so far, data, count
+ *  out: new CRC
+ */
+
+uint32_t crc32_update(uint32_t crc, const char *buf, int count)
+{
+    char	c;
+
+    while (count--) {
+	c = *buf++;
+	crc = (crc >> 4) ^ crc32_table[(crc ^ c) & 15];
+	crc = (crc >> 4) ^ crc32_table[(crc ^ (c >> 4)) & 15];
+    }
+    return crc;
+}
@@ -0,0 +1,47 @@
+/*
+ *  File name:  lib_crc.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Streaming CRC-16/CCITT and CRC-32 with nibble tables.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Each update takes the running CRC and any number of bytes, so a long
+ *  range (a whole flash image, or data as it arrives) can be done in
+ *  pieces. The 16 entry tables cost 32 and 64 bytes of flash, instead
+ *  of 512 and 1024 for byte tables.
+ *
+ *  CRC-16/CCITT-FALSE: poly 0x1021, start 0xffff, no final xor.
+ *  CRC-32 (zip, ethernet): poly 0xedb88320 reflected, start 0xffffffff,
+ *  final xor with 0xffffffff (CRC32_FINAL).
+ *
+ *  Check values for "123456789": CRC-16 0x29b1, CRC-32 0xcbf43926.
+ */
+
+#define CRC16_INIT	0xffff
+#define CRC32_INIT	0xffffffff
+#define CRC32_FINAL(crc) ((crc) ^ 0xffffffff)
+
+/******************************************************************************
+ *
+ *  Add bytes to CRC-16/CCITT
+ *  in: CRC so far, data, count
+ *  out: new CRC
+ */
+
+uint16_t crc16_update(uint16_t, const char *, int);
+
+/******************************************************************************
+ *
+ *  Add bytes to CRC-32
+ *  in: CRC so far, data, count
+ *  out: new CRC (use CRC32_FINAL at the end)
+ */
+
+uint32_t crc32_update(uint32_t, const char *, int);
@@ -0,0 +1,78 @@
+/*
+ *  File name:  lib_decim.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Oversample and decimate ADC readings in the background.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  A 10 bit sample times 256 needs 18 bits, so the sum is 32 bits.
+ *  A 12 bit sample with 4 extra bits still fits the 16 bit result.
+ *
+ *  The result is written by the interrupt, and may change between the
+ *  two byte reads of the main loop. decim_read() reads it again until
+ *  two reads match, which is at most twice since results are slow.
+ */
+
+#include <stdint.h>
+
+#include "lib_decim.h"
+
+/******************************************************************************
+ *
+ *  Set up decimator
+ *  in: decimator, extra bits (DECIM_BITS_MIN to DECIM_BITS_MAX)
+ */
+
+void decim_init(DECIM *d, char bits)
+{
+    if (bits < DECIM_BITS_MIN)
+	bits = DECIM_BITS_MIN;
+    if (bits > DECIM_BITS_MAX)
+	bits = DECIM_BITS_MAX;
+    d->bits = bits;
+    d->sum = 0;
+    d->left = 1 << (bits * 2);
+    d->value = DECIM_NONE;
+    d->fresh = 0;
+}
+
+/******************************************************************************
+ *
+ *  Add raw sample (from interrupt)
+ *  in: decimator, sample (up to 12 bits)
+ */
+
+void decim_add(DECIM *d, uint16_t sample)
+{
+    d->sum += sample;
+    if (--d->left)
+	return;
+    d->value = d->sum >> d->bits;
+    d->fresh = 1;
+    d->sum = 0;
+    d->left = 1 << (d->bits * 2);
+}
+
+/******************************************************************************
+ *
+ *  Get last result, without waiting
+ *  in: decimator
+ *  out: result (sample bits + extra bits), or DECIM_NONE
+ */
+
+uint16_t decim_read(DECIM *d)
+{
+    uint16_t	val;
+
+    do {
+	val = d->value;
+    } while (val != d->value);
+    return val;
+}
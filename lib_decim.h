@@ -0,0 +1,66 @@
+/*
+ *  File name:  lib_decim.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Oversample and decimate ADC readings in the background.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  decim_add() is called with each raw sample, from a timer callback
+ *  (clock_ms with w12_probe() is a good choice). Every 4^bits samples
+ *  the sum is shifted down by bits, for a result with "bits" more bits
+ *  than the samples: 16 samples for 2 bits, 64 for 3, 256 for 4.
+ *
+ *  The extra bits are only real when the input has some noise (a count
+ *  or more), which the W1209 probe has. They also average that noise
+ *  out, so a steady probe gives a steady result.
+ *
+ *  decim_read() gives the last result at once, and never waits for the
+ *  next one. It is DECIM_NONE until the first block is done. "fresh" is
+ *  set with each result, for a caller that wants only new ones to clear.
+ *
+ *  Host test: host/test_decim_host.c
+ */
+
+#define DECIM_BITS_MIN	2
+#define DECIM_BITS_MAX	4
+#define DECIM_NONE	0xffff	/* no result yet */
+
+typedef struct {
+    uint32_t		sum;		/* samples in this block */
+    uint16_t		left;		/* samples to end of block */
+    volatile uint16_t	value;		/* last result */
+    volatile char	fresh;		/* set for each result */
+    char		bits;		/* extra bits */
+} DECIM;
+
+/******************************************************************************
+ *
+ *  Set up decimator
+ *  in: decimator, extra bits (DECIM_BITS_MIN to DECIM_BITS_MAX)
+ */
+
+void decim_init(DECIM *, char);
+
+/******************************************************************************
+ *
+ *  Add raw sample (from interrupt)
+ *  in: decimator, sample (up to 12 bits)
+ */
+
+void decim_add(DECIM *, uint16_t);
+
+/******************************************************************************
+ *
+ *  Get last result, without waiting
+ *  in: decimator
+ *  out: result (sample bits + extra bits), or DECIM_NONE
+ */
+
+uint16_t decim_read(DECIM *);
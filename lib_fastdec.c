@@ -0,0 +1,181 @@
+/*
+ *  File name:  lib_fastdec.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Division-free binary to decimal conversion.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  The STM8 has no 32 bit divide, so bin32_dec() spends most of its
+ *  time in the compiler's long division. Here each digit takes at most
+ *  four compare-and-subtract steps with weights 8, 4, 2, 1 times its
+ *  power of ten. Once the value is below 10000 the work moves to 16 bit
+ *  registers, and below 100 to 8 bit.
+ *
+ *  The 8 bit conversions with BINDEC_LUT are one table lookup each.
+ *
+ *  This file has no hardware access so it also builds on the host.
+ */
+
+#include <stdint.h>
+
+#include "lib_fastdec.h"
+#ifdef BINDEC_LUT
+#include "bindec_lut.h"
+#endif
+
+/* Weights for the top 6 of 10 digits. The first digit is 0-4. */
+
+static const uint32_t dec32_weights[] = {
+    4000000000UL, 2000000000UL, 1000000000UL,
+    800000000UL,  400000000UL,  200000000UL,  100000000UL,
+    80000000UL,   40000000UL,   20000000UL,   10000000UL,
+    8000000UL,    4000000UL,    2000000UL,    1000000UL,
+    800000UL,     400000UL,     200000UL,     100000UL,
+    80000UL,      40000UL,      20000UL,      10000UL
+};
+#define DEC32_END (dec32_weights + sizeof(dec32_weights) / sizeof(uint32_t))
+
+/* Weights for 5 digit value. The first digit is 0-6. */
+
+static const uint16_t dec16_weights[] = {
+    40000, 20000, 10000,
+    8000, 4000, 2000, 1000,
+    800,  400,  200,  100
+};
+#define DEC16_END (dec16_weights + sizeof(dec16_weights) / sizeof(uint16_t))
+#define DEC16_4	  (dec16_weights + 3)	/* start for 4 digits */
+
+static void dec16_put(uint16_t, char *, const uint16_t *, char);
+
+/******************************************************************************
+ *
+ *  Convert 16 bit binary to 5 decimal digits
+ *  in: binary, pointer to 6 byte buffer
+ */
+
+void bin16_dec_fast(uint16_t val, char *dec)
+{
+    dec16_put(val, dec, dec16_weights, 4);
+}
+
+/******************************************************************************
+ *
+ *  Convert 32 bit binary to 10 decimal digits
+ *  in: binary, pointer to 11 byte buffer
+ */
+
+void bin32_dec_fast(uint32_t val, char *dec)
+{
+    const uint32_t *pow;
+    char	digit, weight;
+
+    pow = dec32_weights;
+    weight = 4;
+    digit = '0';
+    while (pow < DEC32_END) {
+	if (val >= *pow) {
+	    val -= *pow;
+	    digit += weight;
+	}
+	pow++;
+	weight >>= 1;
+	if (!weight) {
+	    *dec++ = digit;
+	    digit = '0';
+	    weight = 8;
+	}
+    }
+    dec16_put(val, dec, DEC16_4, 8);	/* val is now below 10000 */
+}
+
+/******************************************************************************
+ *
+ *  Put 16 bit digits, ending with 2 digits in 8 bit math
+ *  in: binary, buffer, first weight, multiple of first weight
+ */
+
+static void dec16_put(uint16_t val, char *dec, const uint16_t *pow,
+		      char weight)
+{
+    char	digit, low;
+
+    digit = '0';
+    while (pow < DEC16_END) {
+	if (val >= *pow) {
+	    val -= *pow;
+	    digit += weight;
+	}
+	pow++;
+	weight >>= 1;
+	if (!weight) {
+	    *dec++ = digit;
+	    digit = '0';
+	    weight = 8;
+	}
+    }
+    low = val;			/* below 100 */
+    if (low >= 80) {
+	low -= 80;
+	digit += 8;
+    }
+    if (low >= 40) {
+	low -= 40;
+	digit += 4;
+    }
+    if (low >= 20) {
+	low -= 20;
+	digit += 2;
+    }
+    if (low >= 10) {
+	low -= 10;
+	digit += 1;
+    }
+    *dec++ = digit;
+    *dec++ = low + '0';
+    *dec = 0;
+}
+
+#ifdef BINDEC_LUT
+/******************************************************************************
+ *
+ *  Convert binary 0-99 to 2 decimal digits
+ *  in: binary, pointer to 3 byte buffer
+ */
+
+void bin8_dec2_fast(char val, char *dec)
+{
+    const char	*lut;
+    unsigned char bval;
+
+    bval = val;
+    while (bval > 99)
+	bval -= 100;
+    lut = bindec_dec2 + (bval << 1);
+    dec[0] = lut[0];
+    dec[1] = lut[1];
+    dec[2] = 0;
+}
+
+/******************************************************************************
+ *
+ *  Convert binary to 2 hex digits
+ *  in: binary, pointer to 3 byte buffer
+ */
+
+void bin8_hex_fast(char val, char *hex)
+{
+    const char	*lut;
+
+    lut = bindec_hex + ((unsigned char)val << 1);
+    hex[0] = lut[0];
+    hex[1] = lut[1];
+    hex[2] = 0;
+}
+#endif /* BINDEC_LUT */
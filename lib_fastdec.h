@@ -0,0 +1,60 @@
+/*
+ *  File name:  lib_fastdec.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Division-free binary to decimal conversion.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Same output as bin16_dec() and bin32_dec() in lib_bindec, but each
+ *  digit is found by subtracting 8, 4, 2, and 1 times its power of ten.
+ *  There is no 32 bit divide, and the low digits use 16 and 8 bit math.
+ *
+ *  With BINDEC_LUT defined, bin8_dec2_fast() and bin8_hex_fast() copy
+ *  from tables in flash (712 bytes, generated into bindec_lut.h by the
+ *  Makefile). Without it, they are the lib_bindec routines.
+ */
+
+/******************************************************************************
+ *
+ *  Convert 16 bit binary to 5 decimal digits
+ *  in: binary, pointer to 6 byte buffer
+ */
+
+void bin16_dec_fast(uint16_t, char *);
+
+/******************************************************************************
+ *
+ *  Convert 32 bit binary to 10 decimal digits
+ *  in: binary, pointer to 11 byte buffer
+ */
+
+void bin32_dec_fast(uint32_t, char *);
+
+#ifdef BINDEC_LUT
+/******************************************************************************
+ *
+ *  Convert binary 0-99 to 2 decimal digits (higher gives last 2 digits)
+ *  in: binary, pointer to 3 byte buffer
+ */
+
+void bin8_dec2_fast(char, char *);
+
+/******************************************************************************
+ *
+ *  Convert binary to 2 hex digits
+ *  in: binary, pointer to 3 byte buffer
+ */
+
+void bin8_hex_fast(char, char *);
+
+#else /* BINDEC_LUT */
+#define bin8_dec2_fast	bin8_dec2
+#define bin8_hex_fast	bin8_hex
+#endif /* BINDEC_LUT */
@@ -0,0 +1,151 @@
+/*
+ *  File name:  lib_flashblk.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Block programming for Flash and EEPROM, run from RAM.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  flashblk_code is written in assembly with only relative branches, so
+ *  it can run anywhere. Its parameters are in fixed globals.
+ *
+ *  Writing FLASH_CR2 (and the complement to FLASH_NCR2) selects the
+ *  mode, then the bytes are written in order to the block. The last
+ *  byte starts the write cycle, and FLASH_IAPSR has EOP when it is
+ *  done, or WR_PG_DIS if the block is protected. Reading FLASH_IAPSR
+ *  clears both.
+ *
+ *  Erase is the same with FLASH_CR2 ERASE and a zero word written to the
+ *  start of the block.
+ */
+
+#include "stm8s_header.h"
+
+#include "lib_flash.h"
+#include "lib_flashblk.h"
+
+#define MODE_ERASE	0x20	/* FLASH_CR2 ERASE */
+#define RAM_SIZE	48	/* room for flashblk_code */
+
+static char	*flashblk_dst;		/* block address */
+static char	*flashblk_src;		/* data in RAM */
+static char	flashblk_count;		/* bytes to write */
+static char	flashblk_mode;		/* FLASH_CR2 value */
+
+static char	flashblk_ram[RAM_SIZE];	/* flashblk_code copied here */
+static char	flashblk_zero[4];
+
+extern char	flashblk_start[];	/* flashblk_code labels */
+extern char	flashblk_end[];
+
+static char flashblk_run(void);
+
+/******************************************************************************
+ *
+ *  Block write routine, copied to RAM
+ *  out: A = non-zero if write protected
+ */
+
+void flashblk_code(void) __naked
+{
+    __asm
+_flashblk_start::
+	ld	a, _flashblk_mode
+	ld	0x505b, a		; FLASH_CR2
+	cpl	a
+	ld	0x505c, a		; FLASH_NCR2
+	ldw	x, _flashblk_src
+	ldw	y, _flashblk_dst
+00001$:
+	ld	a, (x)
+	ld	(y), a
+	incw	x
+	incw	y
+	dec	_flashblk_count
+	jrne	00001$
+00002$:
+	ld	a, 0x505f		; FLASH_IAPSR
+	and	a, #0x05		; EOP or WR_PG_DIS
+	jreq	00002$
+	and	a, #0x01		; WR_PG_DIS
+	ret
+_flashblk_end::
+    __endasm;
+}
+
+/******************************************************************************
+ *
+ *  Copy block write routine to RAM
+ */
+
+void flashblk_init(void)
+{
+    char	*src, *dst;
+
+    src = flashblk_start;
+    dst = flashblk_ram;
+    while (src != flashblk_end)
+	*dst++ = *src++;
+}
+
+/******************************************************************************
+ *
+ *  Write one block
+ *  in: block address, data (in RAM), FLASHBLK_STANDARD or FLASHBLK_FAST
+ *  out: FLASHBLK_OK or error
+ */
+
+char flashblk_write(char *dst, char *src, char mode)
+{
+    if ((int)dst & (FLASHBLK_SIZE - 1))
+	return FLASHBLK_ALIGN;
+
+    flashblk_dst = dst;
+    flashblk_src = src;
+    flashblk_count = FLASHBLK_SIZE;
+    flashblk_mode = mode;
+    return flashblk_run();
+}
+
+/******************************************************************************
+ *
+ *  Erase one block
+ *  in: block address
+ *  out: FLASHBLK_OK or error
+ */
+
+char flashblk_erase(char *dst)
+{
+    if ((int)dst & (FLASHBLK_SIZE - 1))
+	return FLASHBLK_ALIGN;
+
+    flashblk_dst = dst;
+    flashblk_src = flashblk_zero;
+    flashblk_count = 4;
+    flashblk_mode = MODE_ERASE;
+    return flashblk_run();
+}
+
+/******************************************************************************
+ *
+ *  Unlock, run RAM routine with interrupts off, lock
+ *  out: FLASHBLK_OK or FLASHBLK_PROTECT
+ */
+
+static char flashblk_run(void)
+{
+    char	retval;
+
+    flash_unlock();
+    __asm__ ("sim");		/* vectors are in flash */
+    retval = ((char (*)(void))flashblk_ram)();
+    __asm__ ("rim");
+    flash_lock();
+    return retval ? FLASHBLK_PROTECT : FLASHBLK_OK;
+}
@@ -0,0 +1,62 @@
+/*
+ *  File name:  lib_flashblk.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Block programming for Flash and EEPROM, run from RAM.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  A block write programs a whole block in one write cycle, the same
+ *  time as one byte. The STM8S cannot read program memory while it is
+ *  being written, so the write loop is copied to RAM by flashblk_init()
+ *  and runs there with interrupts off.
+ *
+ *  Standard mode erases and programs any block. Fast mode only programs,
+ *  in about half the time, so the block must already be erased (zero).
+ *
+ *  Uses lib_flash to unlock and lock the memory.
+ */
+
+#ifdef STM8105
+#define FLASHBLK_SIZE	128	/* block size, medium density */
+#else
+#define FLASHBLK_SIZE	64	/* block size, low density */
+#endif
+
+#define FLASHBLK_STANDARD 0x01	/* FLASH_CR2 PRG: erase and program */
+#define FLASHBLK_FAST	0x10	/* FLASH_CR2 FPRG: program erased block */
+
+#define FLASHBLK_OK	0
+#define FLASHBLK_PROTECT 1	/* block is write protected */
+#define FLASHBLK_ALIGN	2	/* address is not start of a block */
+
+/******************************************************************************
+ *
+ *  Copy block write routine to RAM
+ */
+
+void flashblk_init(void);
+
+/******************************************************************************
+ *
+ *  Write one block
+ *  in: block address, data (in RAM), FLASHBLK_STANDARD or FLASHBLK_FAST
+ *  out: FLASHBLK_OK or error
+ */
+
+char flashblk_write(char *, char *, char);
+
+/******************************************************************************
+ *
+ *  Erase one block
+ *  in: block address
+ *  out: FLASHBLK_OK or error
+ */
+
+char flashblk_erase(char *);
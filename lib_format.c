@@ -0,0 +1,142 @@
+/*
+ *  File name:  lib_format.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Small printf-like line formatter.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Numbers are converted once into a 10 digit scratch area on the stack,
+ *  then copied into place without the leading zeros. There is no
+ *  separate rlz pass and no intermediate string for the caller to copy.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "lib_fastdec.h"
+#include "lib_format.h"
+
+static char *fmt_num(char *, uint32_t, char, char, char);
+
+/******************************************************************************
+ *
+ *  Format line into buffer
+ *  in: buffer, format, arguments
+ *  out: pointer to the terminating zero
+ */
+
+char *fmt_line(char *buf, const char *fmt, ...)
+{
+    va_list	ap;
+    const char	*str;
+    uint32_t	val;
+    char	c, zero, width, is_long, minus;
+
+    va_start(ap, fmt);
+    while ((c = *fmt++)) {
+	if (c != '%') {
+	    *buf++ = c;
+	    continue;
+	}
+	zero = 0;
+	width = 0;
+	is_long = 0;
+	minus = 0;
+	c = *fmt++;
+	if (c == '0') {
+	    zero = 1;
+	    c = *fmt++;
+	}
+	while (c >= '0' && c <= '9') {
+	    width = width * 10 + c - '0';
+	    c = *fmt++;
+	}
+	if (c == 'l') {
+	    is_long = 1;
+	    c = *fmt++;
+	}
+	switch (c) {
+	case 'u' :
+	case 'd' :
+	    if (is_long)
+		val = va_arg(ap, unsigned long);
+	    else if (c == 'd')
+		val = (int32_t)(int16_t)va_arg(ap, int);
+	    else
+		val = (uint16_t)va_arg(ap, unsigned int);
+	    if (c == 'd' && (int32_t)val < 0) {
+		minus = 1;
+		val = -val;
+	    }
+	    buf = fmt_num(buf, val, width, zero, minus);
+	    break;
+	case 'x' :
+	    bin8_hex_fast(va_arg(ap, int), buf);
+	    buf += 2;
+	    break;
+	case 'c' :
+	    *buf++ = va_arg(ap, int);
+	    break;
+	case 's' :
+	    str = va_arg(ap, const char *);
+	    while (*str)
+		*buf++ = *str++;
+	    break;
+	case 0 :
+	    fmt--;		/* '%' at end of format */
+	    break;
+	default :
+	    *buf++ = c;		/* includes "%%" */
+	    break;
+	}
+    }
+    va_end(ap);
+    *buf = 0;
+    return buf;
+}
+
+/******************************************************************************
+ *
+ *  Put number with padding
+ *  in: buffer, value, width, zero pad flag, minus flag
+ *  out: end of number in buffer
+ */
+
+static char *fmt_num(char *buf, uint32_t val, char width, char zero,
+		     char minus)
+{
+    char	digits[11];
+    char	*dp;
+    char	len;
+
+    if (val < 0x10000) {
+	bin16_dec_fast(val, digits + 5);
+	dp = digits + 5;
+    }
+    else {
+	bin32_dec_fast(val, digits);
+	dp = digits;
+    }
+    while (*dp == '0' && dp[1])	/* skip leading zeros, keep one */
+	dp++;
+    len = digits + 10 - dp + minus;
+
+    if (minus && zero)
+	*buf++ = '-';
+    while (width > len) {
+	*buf++ = zero ? '0' : ' ';
+	width--;
+    }
+    if (minus && !zero)
+	*buf++ = '-';
+    while (*dp)
+	*buf++ = *dp++;
+    return buf;
+}
@@ -0,0 +1,41 @@
+/*
+ *  File name:  lib_format.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Small printf-like line formatter.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Formats a whole line into the caller's buffer in one pass, using the
+ *  division-free conversions of lib_fastdec. Much smaller than printf.
+ *
+ *  Conversions, with optional '0' flag and width (up to 10):
+ *
+ *  %u   unsigned int	%lu  unsigned long
+ *  %d   int		%ld  long
+ *  %x   int, low byte shown as 2 hex
+ *  %c   character	%s   string
+ *  %%   percent sign
+ *
+ *  Pass %x and %c values as int. SDCC pushes an argument cast to char
+ *  as one byte, which shifts every argument after it.
+ *
+ *  Example:
+ *	fmt_line(buf, "%5u inches ", dist);
+ *	uart_puts(buf);
+ */
+
+/******************************************************************************
+ *
+ *  Format line into buffer
+ *  in: buffer, format, arguments
+ *  out: pointer to the terminating zero, for appending more
+ */
+
+char *fmt_line(char *, const char *, ...);
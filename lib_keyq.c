@@ -0,0 +1,203 @@
+/*
+ *  File name:  lib_keyq.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Key event queue with timestamps, long press and repeat.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  The writer fills the slot before it moves keyq_in, and the reader
+ *  copies the slot out before it moves keyq_out. Both indexes are single
+ *  bytes, so each side sees the other's index whole. The indexes run
+ *  free, and (in - out) is the number of events waiting.
+ *
+ *  Long press and repeat time only the key that was pressed last, and
+ *  only while it is down alone. Any other press or release stops them.
+ *  Nothing more is done in a poll with no change and no held key.
+ */
+
+#include <stdint.h>
+
+#include "lib_keyq.h"
+
+#define RING_MASK	(KEYQ_SIZE - 1)
+#define HELD_NONE	0xff
+
+volatile char	keyq_lost;
+
+static KEYQ_EVENT	keyq_ring[KEYQ_SIZE];
+static volatile char	keyq_in;
+static volatile char	keyq_out;
+
+static const char	*keyq_map;
+static uint16_t		keyq_long;	/* ms to long press */
+static uint16_t		keyq_rep;	/* ms between repeats */
+static volatile uint16_t keyq_ms;	/* millisecond count */
+static uint16_t		keyq_down;	/* keys down at last poll */
+static uint16_t		keyq_wait;	/* ms to long press or repeat */
+static uint8_t		keyq_held;	/* key being timed */
+static char		keyq_longed;	/* long press sent */
+
+static void keyq_held_start(uint16_t, uint16_t);
+static void keyq_put(uint8_t, char);
+
+/******************************************************************************
+ *
+ *  Set up queue
+ *  in: key map (one character per key bit), long press ms, repeat ms
+ */
+
+void keyq_init(const char *map, uint16_t long_ms, uint16_t repeat_ms)
+{
+    keyq_map = map;
+    keyq_long = long_ms;
+    keyq_rep = repeat_ms;
+    keyq_ms = 0;
+    keyq_down = 0;
+    keyq_held = HELD_NONE;
+    keyq_in = 0;
+    keyq_out = 0;
+    keyq_lost = 0;
+}
+
+/******************************************************************************
+ *
+ *  Load key map, keep events and times
+ *  in: key map (one character per key bit)
+ */
+
+void keyq_kmap(const char *map)
+{
+    keyq_map = map;
+}
+
+/******************************************************************************
+ *
+ *  Take keys down, queue events (from millisecond timer)
+ *  in: one bit per key down
+ */
+
+void keyq_poll(uint16_t keys)
+{
+    uint16_t	changed, bit;
+    uint8_t	key;
+
+    keyq_ms++;
+    changed = keys ^ keyq_down;
+    if (changed) {
+	keyq_down = keys;
+	bit = 1;
+	for (key = 0; key < 16; key++) {
+	    if (changed & bit) {
+		if (!(keys & bit))
+		    keyq_put(key, KEYQ_RELEASE);
+		else {
+		    keyq_put(key, KEYQ_PRESS);
+		    if (keys & ~bit)
+			keyq_put(key, KEYQ_CHORD);
+		}
+	    }
+	    bit <<= 1;
+	}
+	keyq_held_start(keys, changed);
+	return;
+    }
+
+    if (keyq_held == HELD_NONE || --keyq_wait)
+	return;
+    if (keyq_longed)
+	keyq_put(keyq_held, KEYQ_REPEAT);
+    else {
+	keyq_put(keyq_held, KEYQ_LONG);
+	keyq_longed = 1;
+    }
+    keyq_wait = keyq_rep;
+    if (!keyq_rep)
+	keyq_held = HELD_NONE;		/* long press only */
+}
+
+/******************************************************************************
+ *
+ *  Get next event
+ *  in: place for event
+ *  out: 1 for event, 0 for none
+ */
+
+char keyq_get(KEYQ_EVENT *ev)
+{
+    KEYQ_EVENT	*slot;
+
+    if (keyq_out == keyq_in)
+	return 0;
+    slot = &keyq_ring[keyq_out & RING_MASK];
+    ev->time = slot->time;
+    ev->keys = slot->keys;
+    ev->code = slot->code;
+    ev->type = slot->type;
+    keyq_out++;
+    return 1;
+}
+
+/******************************************************************************
+ *
+ *  Get millisecond count
+ *  out: same count as event times
+ */
+
+uint16_t keyq_now(void)
+{
+    uint16_t	ms;
+
+    do {
+	ms = keyq_ms;
+    } while (ms != keyq_ms);
+    return ms;
+}
+
+/******************************************************************************
+ *
+ *  Start timing a key that was just pressed and is down alone
+ *  in: keys down, keys changed
+ */
+
+static void keyq_held_start(uint16_t keys, uint16_t changed)
+{
+    uint8_t	key;
+
+    keyq_held = HELD_NONE;
+    if (!keyq_long || (keys & (keys - 1)) || !(keys & changed))
+	return;			/* none, more than one, or not new */
+    for (key = 0; !(keys & 1); key++)
+	keys >>= 1;
+    keyq_held = key;
+    keyq_wait = keyq_long;
+    keyq_longed = 0;
+}
+
+/******************************************************************************
+ *
+ *  Queue event, or count it lost
+ *  in: key bit, event type
+ */
+
+static void keyq_put(uint8_t key, char type)
+{
+    KEYQ_EVENT	*slot;
+
+    if ((char)(keyq_in - keyq_out) >= KEYQ_SIZE) {
+	keyq_lost++;
+	return;
+    }
+    slot = &keyq_ring[keyq_in & RING_MASK];
+    slot->time = keyq_ms;
+    slot->keys = keyq_down;
+    slot->code = keyq_map[key];
+    slot->type = type;
+    keyq_in++;
+}
@@ -0,0 +1,97 @@
+/*
+ *  File name:  lib_keyq.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Key event queue with timestamps, long press and repeat.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  keyq_poll() is called from the millisecond timer with the keys that
+ *  are down now, one bit per key (tmfb_poll() calls it itself). It
+ *  counts the milliseconds, finds presses and releases, and puts events
+ *  in a ring for the main loop to take with keyq_get(). Each event has
+ *  the millisecond count when it happened, so a slow main loop still
+ *  sees when keys went down and up.
+ *
+ *  Event types:
+ *
+ *  KEYQ_PRESS, KEYQ_RELEASE: one for each key that changed.
+ *  KEYQ_CHORD: after the press of a key that makes two or more down.
+ *	"keys" has all of them.
+ *  KEYQ_LONG: one key held alone for long_ms.
+ *  KEYQ_REPEAT: every repeat_ms after KEYQ_LONG, while still held.
+ *
+ *  The ring has one writer (the timer) and one reader (the main loop),
+ *  and each side only moves its own index, so no interrupts are turned
+ *  off. If the ring is full, new events are dropped and counted in
+ *  keyq_lost.
+ *
+ *  Host test: host/test_keyq_host.c
+ */
+
+#ifndef KEYQ_SIZE
+#define KEYQ_SIZE	16	/* events in ring, power of 2 */
+#endif
+
+#define KEYQ_PRESS	1
+#define KEYQ_RELEASE	2
+#define KEYQ_CHORD	3
+#define KEYQ_LONG	4
+#define KEYQ_REPEAT	5
+
+typedef struct {
+    uint16_t	time;		/* milliseconds, from keyq_poll() count */
+    uint16_t	keys;		/* keys down after the event */
+    char	code;		/* key from map */
+    char	type;		/* KEYQ_PRESS to KEYQ_REPEAT */
+} KEYQ_EVENT;
+
+extern volatile char	keyq_lost;	/* events dropped, ring full */
+
+/******************************************************************************
+ *
+ *  Set up queue
+ *  in: key map (one character per key bit), long press ms, repeat ms
+ *  (0 for no long press, or no repeat)
+ */
+
+void keyq_init(const char *, uint16_t, uint16_t);
+
+/******************************************************************************
+ *
+ *  Load key map, keep events and times
+ *  in: key map (one character per key bit)
+ */
+
+void keyq_kmap(const char *);
+
+/******************************************************************************
+ *
+ *  Take keys down, queue events (from millisecond timer)
+ *  in: one bit per key down
+ */
+
+void keyq_poll(uint16_t);
+
+/******************************************************************************
+ *
+ *  Get next event
+ *  in: place for event
+ *  out: 1 for event, 0 for none
+ */
+
+char keyq_get(KEYQ_EVENT *);
+
+/******************************************************************************
+ *
+ *  Get millisecond count
+ *  out: same count as event times
+ */
+
+uint16_t keyq_now(void);
@@ -0,0 +1,348 @@
+/*
+ *  File name:  lib_kvlog.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Log-structured key/value store in Flash or EEPROM.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  kv_index[] holds the address of the latest committed record of each
+ *  key, or zero. kv_next is where the next record goes.
+ *
+ *  Zero bytes are not written, since erased memory is already zero.
+ *  kv_blk[] is all zero between compactions: kv_flush() clears it.
+ */
+
+#include <stdint.h>
+
+#include "lib_flash.h"
+#include "lib_flashblk.h"
+#include "lib_kvlog.h"
+
+#define MAGIC_0		'K'
+#define MAGIC_1		'V'
+#define COMMIT		0xa5
+#define HEADER		4	/* bytes in area header */
+
+#define REC_SIZE(len)	(((len) + 6) & ~3)	/* key, len, data, commit */
+
+static char	*kv_area[2];		/* start of each area */
+static int	kv_size;		/* bytes in each area */
+static uint8_t	kv_active;		/* 0 or 1 */
+static char	*kv_next;		/* next record */
+static char	*kv_end;		/* end of active area */
+static char	kv_area_seq;		/* sequence of active area */
+static char	*kv_index[KV_KEYS];	/* latest record of each key */
+static char	kv_blk[FLASHBLK_SIZE];	/* block built by compaction */
+
+static char kv_header(char *);
+static void kv_start(uint8_t, char);
+static void kv_scan(void);
+static void kv_erase(char *);
+static void kv_flush(char *);
+static void kv_write(char *, char *, char);
+static void kv_byte(char *, char);
+
+/******************************************************************************
+ *
+ *  Find active area and build index
+ *  in: start of first area, size of each area
+ *  out: number of keys found
+ */
+
+char kv_init(char *base, int size)
+{
+    char	ok0, ok1, count;
+    uint8_t	i;
+
+    kv_area[0] = base;
+    kv_area[1] = base + size;
+    kv_size = size;
+
+    ok0 = kv_header(kv_area[0]);
+    ok1 = kv_header(kv_area[1]);
+    if (!ok0 && !ok1) {
+	kv_erase(kv_area[0]);
+	kv_erase(kv_area[1]);
+	kv_start(0, 1);
+	kv_scan();		/* empty index */
+	return 0;
+    }
+    kv_active = 0;
+    if (!ok0 || (ok1 && (signed char)(kv_area[1][2] - kv_area[0][2]) > 0))
+	kv_active = 1;
+    kv_area_seq = kv_area[kv_active][2];
+    kv_scan();
+
+    count = 0;
+    for (i = 0; i < KV_KEYS; i++)
+	if (kv_index[i])
+	    count++;
+    return count;
+}
+
+/******************************************************************************
+ *
+ *  Get value
+ *  in: key, buffer, buffer size
+ *  out: length of value, zero if not found
+ */
+
+char kv_get(char key, char *buf, char size)
+{
+    char	*rec;
+    char	len;
+    uint8_t	i;
+
+    if (!key || key > KV_KEYS)
+	return 0;
+    rec = kv_index[key - 1];
+    if (!rec)
+	return 0;
+    len = rec[1];
+    for (i = 0; i < len && i < size; i++)
+	buf[i] = rec[2 + i];
+    return len;
+}
+
+/******************************************************************************
+ *
+ *  Store value
+ *  in: key, data, length (zero to delete)
+ *  out: KV_OK or error
+ */
+
+char kv_put(char key, char *data, char len)
+{
+    char	*rec;
+    char	size;
+    uint8_t	i;
+
+    if (!key || key > KV_KEYS)
+	return KV_BADKEY;
+    if (len > KV_MAXLEN)
+	return KV_TOOBIG;
+
+    rec = kv_index[key - 1];
+    if (rec && rec[1] == len) {
+	for (i = 0; i < len; i++)
+	    if (rec[2 + i] != data[i])
+		break;
+	if (i == len)
+	    return KV_OK;	/* no change */
+    }
+    if (!rec && !len)
+	return KV_OK;		/* already deleted */
+
+    size = REC_SIZE(len);
+    if (kv_end - kv_next < size)
+	kv_compact();
+    if (kv_end - kv_next < size)
+	return KV_FULL;
+
+    rec = kv_next;
+    flash_unlock();
+    kv_byte(rec, key);
+    kv_byte(rec + 1, len);
+    kv_write(rec + 2, data, len);
+    kv_byte(rec + size - 1, COMMIT);	/* record is valid now */
+    flash_lock();
+
+    kv_next += size;
+    kv_index[key - 1] = len ? rec : 0;
+    return KV_OK;
+}
+
+/******************************************************************************
+ *
+ *  Copy live records to the other area and make it active
+ *  out: bytes free in the new area
+ */
+
+int kv_compact(void)
+{
+    char	*blk, *rec;
+    char	size;
+    uint8_t	spare, pos, i;
+
+    spare = kv_active ^ 1;
+    blk = kv_area[spare];
+    kv_erase(blk);
+
+    pos = HEADER;			/* header is left for kv_start() */
+    for (i = 0; i < KV_KEYS; i++) {
+	rec = kv_index[i];
+	if (!rec)
+	    continue;
+	kv_index[i] = blk + pos;
+	size = REC_SIZE(rec[1]);	/* commit byte included */
+	while (size--) {
+	    kv_blk[pos++] = *rec++;
+	    if (pos == FLASHBLK_SIZE) {
+		kv_flush(blk);
+		blk += FLASHBLK_SIZE;
+		pos = 0;
+	    }
+	}
+    }
+    if (pos > (blk == kv_area[spare] ? HEADER : 0))
+	kv_flush(blk);			/* last part block */
+
+    kv_start(spare, kv_area_seq + 1);
+    kv_next = blk + pos;
+    return kv_free();
+}
+
+/******************************************************************************
+ *
+ *  Get bytes free in the active area
+ */
+
+int kv_free(void)
+{
+    return kv_end - kv_next;
+}
+
+/******************************************************************************
+ *
+ *  Get sequence number of the active area
+ */
+
+char kv_seq(void)
+{
+    return kv_area_seq;
+}
+
+/******************************************************************************
+ *
+ *  Check area header
+ *  in: area
+ *  out: non-zero if valid
+ */
+
+static char kv_header(char *area)
+{
+    return area[0] == MAGIC_0 && area[1] == MAGIC_1 &&
+	(char)(area[2] ^ area[3]) == 0xff;
+}
+
+/******************************************************************************
+ *
+ *  Write header to make area active (area must be clear)
+ *  in: area number, sequence
+ */
+
+static void kv_start(uint8_t area, char seq)
+{
+    char	*ptr;
+
+    ptr = kv_area[area];
+    flash_unlock();
+    kv_byte(ptr + 3, ~seq);
+    kv_byte(ptr + 2, seq);
+    kv_byte(ptr + 1, MAGIC_1);
+    kv_byte(ptr, MAGIC_0);		/* area is valid now */
+    flash_lock();
+
+    kv_active = area;
+    kv_area_seq = seq;
+    kv_end = ptr + kv_size;
+    kv_next = ptr + HEADER;
+}
+
+/******************************************************************************
+ *
+ *  Scan active area, build index, find end of log
+ */
+
+static void kv_scan(void)
+{
+    char	*rec;
+    char	key, size;
+    uint8_t	i;
+
+    for (i = 0; i < KV_KEYS; i++)
+	kv_index[i] = 0;
+
+    rec = kv_area[kv_active] + HEADER;
+    kv_end = kv_area[kv_active] + kv_size;
+    while (kv_end - rec >= 4) {
+	key = rec[0];
+	if (!key)
+	    break;		/* end of log */
+	size = REC_SIZE(rec[1]);
+	if (rec[1] > KV_MAXLEN || kv_end - rec < size) {
+	    rec = kv_end;	/* damaged, treat as full */
+	    break;
+	}
+	if (rec[size - 1] == COMMIT && key <= KV_KEYS)
+	    kv_index[key - 1] = rec[1] ? rec : 0;
+	rec += size;		/* skip torn records too */
+    }
+    kv_next = rec;
+}
+
+/******************************************************************************
+ *
+ *  Erase area, skipping blocks that are already blank
+ *  in: area
+ */
+
+static void kv_erase(char *area)
+{
+    char	*blk;
+    uint8_t	i;
+
+    for (blk = area; blk != area + kv_size; blk += FLASHBLK_SIZE) {
+	for (i = 0; i < FLASHBLK_SIZE; i++)
+	    if (blk[i])
+		break;
+	if (i < FLASHBLK_SIZE)
+	    flashblk_erase(blk);
+    }
+}
+
+/******************************************************************************
+ *
+ *  Write built block to erased flash, clear it for the next one
+ *  in: block address
+ */
+
+static void kv_flush(char *blk)
+{
+    uint8_t	i;
+
+    flashblk_write(blk, kv_blk, FLASHBLK_FAST);
+    for (i = 0; i < FLASHBLK_SIZE; i++)
+	kv_blk[i] = 0;
+}
+
+/******************************************************************************
+ *
+ *  Write bytes (memory is unlocked)
+ *  in: destination, source, count
+ */
+
+static void kv_write(char *dst, char *src, char count)
+{
+    while (count--)
+	kv_byte(dst++, *src++);
+}
+
+/******************************************************************************
+ *
+ *  Write one byte, if not zero (memory is unlocked)
+ *  in: destination, value
+ */
+
+static void kv_byte(char *dst, char val)
+{
+    if (val)
+	*dst = val;
+}
@@ -0,0 +1,108 @@
+/*
+ *  File name:  lib_kvlog.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Log-structured key/value store in Flash or EEPROM.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Small values (setpoints, counters) are kept as records appended to
+ *  one of two equal areas. Nothing is written in place: a new value is
+ *  a new record, and the RAM index points to the latest one of each
+ *  key. When the area is full, the live records are copied to the
+ *  other area, which then becomes the active one. Each area is erased
+ *  once per compaction, so erase wear is spread over both.
+ *
+ *  Area:	header word: 'K' 'V' seq ~seq, then records
+ *  Record:	key, length, data, zero pad, 0xA5 commit byte
+ *
+ *  Records start on 4 byte word boundaries, and the commit byte is
+ *  written last. The STM8 may erase and reprogram a whole word to write
+ *  one byte, so a record never shares a word with an older one. After
+ *  a power loss, a record without its commit byte is skipped, and a
+ *  compaction that did not finish leaves the old area active, since the
+ *  new header is written last.
+ *
+ *  A compaction builds each block of the new area in RAM and writes it
+ *  in fast mode with lib_flashblk, one program cycle per block, after
+ *  erasing only the blocks that are not blank. A single record from
+ *  kv_put() is still programmed a byte at a time, one cycle for each
+ *  byte that is not zero.
+ *
+ *  Keys are 1 to KV_KEYS. A zero length record deletes the key.
+ *  Uses lib_flash and lib_flashblk (call flashblk_init first).
+ *  Erased memory on the STM8 reads as zero.
+ */
+
+#ifndef KV_KEYS
+#define KV_KEYS		16	/* keys 1 to KV_KEYS */
+#endif
+
+#define KV_MAXLEN	32	/* longest value */
+
+#define KV_OK		0
+#define KV_FULL		1	/* no room even after compaction */
+#define KV_BADKEY	2
+#define KV_TOOBIG	3
+
+/******************************************************************************
+ *
+ *  Find active area and build index
+ *  in: start of first area (block aligned), size of each area
+ *      (multiple of FLASHBLK_SIZE)
+ *  out: number of keys found
+ *
+ *  The second area follows the first. If neither has a valid header,
+ *  both are cleared and the first is started empty.
+ */
+
+char kv_init(char *, int);
+
+/******************************************************************************
+ *
+ *  Get value
+ *  in: key, buffer, buffer size
+ *  out: length of value, zero if not found (buffer gets up to size)
+ */
+
+char kv_get(char, char *, char);
+
+/******************************************************************************
+ *
+ *  Store value
+ *  in: key, data, length (zero to delete)
+ *  out: KV_OK or error
+ *
+ *  If the value is the same as the stored one, nothing is written.
+ */
+
+char kv_put(char, char *, char);
+
+/******************************************************************************
+ *
+ *  Copy live records to the other area and make it active
+ *  out: bytes free in the new area
+ */
+
+int kv_compact(void);
+
+/******************************************************************************
+ *
+ *  Get bytes free in the active area
+ */
+
+int kv_free(void);
+
+/******************************************************************************
+ *
+ *  Get sequence number of the active area
+ *  out: compaction count, mod 256
+ */
+
+char kv_seq(void);
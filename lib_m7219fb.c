@@ -0,0 +1,532 @@
+/*
+ *  File name:  lib_m7219fb.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: MAX7219 chain with shadow framebuffer, on hardware SPI.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Each MAX7219 takes a 16 bit word, register then data, and passes the
+ *  previous word along to the next module. With LOAD low, a row write
+ *  shifts one word per module, farthest module first, and the rising
+ *  edge of LOAD latches all of them at once. A no-op word (register 0)
+ *  leaves a module unchanged.
+ *
+ *  m7fb_dirty[] has one bit per module for each digit row, so the
+ *  header holds M7FB_MAX to 16.
+ *
+ *  The marquee font is the classic 5x7 table, one byte per column with
+ *  bit 0 on top, from space to '~'. Each character takes 5 columns and
+ *  a blank one.
+ */
+
+#include <stdint.h>
+
+#include "stm8s_header.h"
+
+#include "lib_m7219fb.h"
+
+/* MAX7219 registers */
+
+#define REG_NOOP	0x00
+#define REG_DIGIT0	0x01
+#define REG_DECODE	0x09
+#define REG_INTENSITY	0x0a
+#define REG_SCAN	0x0b
+#define REG_SHUTDOWN	0x0c
+#define REG_TEST	0x0f
+
+/* SPI register bits */
+
+#define CR1_SPE		0x40
+#define CR1_MSTR	0x04
+#define CR1_4MHZ	0x08	/* MAX7219 maximum is 10 mhz */
+#define CR2_BDM		0x80
+#define CR2_BDOE	0x40
+#define CR2_SSM		0x02
+#define CR2_SSI		0x01
+#define SR_BSY		0x80
+#define SR_TXE		0x02
+
+/* Code-B characters */
+
+#define CODE_DASH	0x0a
+#define CODE_E		0x0b
+#define CODE_H		0x0c
+#define CODE_L		0x0d
+#define CODE_P		0x0e
+#define CODE_BLANK	0x0f
+#define CODE_DP		0x80
+
+static char	m7fb_buf[8][M7FB_MAX];	/* [digit][module] */
+static uint16_t	m7fb_dirty[8];		/* modules changed, per digit */
+static char	m7fb_count;		/* modules in chain */
+
+#define RING_SIZE	16	/* marquee columns, power of 2 */
+#define RING_MASK	(RING_SIZE - 1)
+
+static char	m7fb_ring[RING_SIZE];	/* rendered columns */
+static char	m7fb_ring_in;
+static char	m7fb_ring_out;
+static const char *m7fb_mstr;		/* marquee string */
+static const char *m7fb_mptr;		/* next character to render */
+static char	m7fb_mrate;		/* ticks per column */
+static char	m7fb_mwait;		/* ticks to next column */
+static volatile char m7fb_mrun;
+
+static const char m7fb_font[95 * 5] = {
+    0x00, 0x00, 0x00, 0x00, 0x00,	/* space */
+    0x00, 0x00, 0x5f, 0x00, 0x00,	/* ! */
+    0x00, 0x07, 0x00, 0x07, 0x00,	/* " */
+    0x14, 0x7f, 0x14, 0x7f, 0x14,	/* # */
+    0x24, 0x2a, 0x7f, 0x2a, 0x12,	/* $ */
+    0x23, 0x13, 0x08, 0x64, 0x62,	/* % */
+    0x36, 0x49, 0x56, 0x20, 0x50,	/* & */
+    0x00, 0x08, 0x07, 0x03, 0x00,	/* ' */
+    0x00, 0x1c, 0x22, 0x41, 0x00,	/* ( */
+    0x00, 0x41, 0x22, 0x1c, 0x00,	/* ) */
+    0x2a, 0x1c, 0x7f, 0x1c, 0x2a,	/* * */
+    0x08, 0x08, 0x3e, 0x08, 0x08,	/* + */
+    0x00, 0x80, 0x70, 0x30, 0x00,	/* , */
+    0x08, 0x08, 0x08, 0x08, 0x08,	/* - */
+    0x00, 0x00, 0x60, 0x60, 0x00,	/* . */
+    0x20, 0x10, 0x08, 0x04, 0x02,	/* / */
+    0x3e, 0x51, 0x49, 0x45, 0x3e,	/* 0 */
+    0x00, 0x42, 0x7f, 0x40, 0x00,	/* 1 */
+    0x72, 0x49, 0x49, 0x49, 0x46,	/* 2 */
+    0x21, 0x41, 0x49, 0x4d, 0x33,	/* 3 */
+    0x18, 0x14, 0x12, 0x7f, 0x10,	/* 4 */
+    0x27, 0x45, 0x45, 0x45, 0x39,	/* 5 */
+    0x3c, 0x4a, 0x49, 0x49, 0x31,	/* 6 */
+    0x41, 0x21, 0x11, 0x09, 0x07,	/* 7 */
+    0x36, 0x49, 0x49, 0x49, 0x36,	/* 8 */
+    0x46, 0x49, 0x49, 0x29, 0x1e,	/* 9 */
+    0x00, 0x00, 0x14, 0x00, 0x00,	/* : */
+    0x00, 0x40, 0x34, 0x00, 0x00,	/* ; */
+    0x00, 0x08, 0x14, 0x22, 0x41,	/* < */
+    0x14, 0x14, 0x14, 0x14, 0x14,	/* = */
+    0x00, 0x41, 0x22, 0x14, 0x08,	/* > */
+    0x02, 0x01, 0x59, 0x09, 0x06,	/* ? */
+    0x3e, 0x41, 0x5d, 0x59, 0x4e,	/* @ */
+    0x7c, 0x12, 0x11, 0x12, 0x7c,	/* A */
+    0x7f, 0x49, 0x49, 0x49, 0x36,	/* B */
+    0x3e, 0x41, 0x41, 0x41, 0x22,	/* C */
+    0x7f, 0x41, 0x41, 0x41, 0x3e,	/* D */
+    0x7f, 0x49, 0x49, 0x49, 0x41,	/* E */
+    0x7f, 0x09, 0x09, 0x09, 0x01,	/* F */
+    0x3e, 0x41, 0x41, 0x51, 0x73,	/* G */
+    0x7f, 0x08, 0x08, 0x08, 0x7f,	/* H */
+    0x00, 0x41, 0x7f, 0x41, 0x00,	/* I */
+    0x20, 0x40, 0x41, 0x3f, 0x01,	/* J */
+    0x7f, 0x08, 0x14, 0x22, 0x41,	/* K */
+    0x7f, 0x40, 0x40, 0x40, 0x40,	/* L */
+    0x7f, 0x02, 0x1c, 0x02, 0x7f,	/* M */
+    0x7f, 0x04, 0x08, 0x10, 0x7f,	/* N */
+    0x3e, 0x41, 0x41, 0x41, 0x3e,	/* O */
+    0x7f, 0x09, 0x09, 0x09, 0x06,	/* P */
+    0x3e, 0x41, 0x51, 0x21, 0x5e,	/* Q */
+    0x7f, 0x09, 0x19, 0x29, 0x46,	/* R */
+    0x26, 0x49, 0x49, 0x49, 0x32,	/* S */
+    0x03, 0x01, 0x7f, 0x01, 0x03,	/* T */
+    0x3f, 0x40, 0x40, 0x40, 0x3f,	/* U */
+    0x1f, 0x20, 0x40, 0x20, 0x1f,	/* V */
+    0x3f, 0x40, 0x38, 0x40, 0x3f,	/* W */
+    0x63, 0x14, 0x08, 0x14, 0x63,	/* X */
+    0x03, 0x04, 0x78, 0x04, 0x03,	/* Y */
+    0x61, 0x59, 0x49, 0x4d, 0x43,	/* Z */
+    0x00, 0x7f, 0x41, 0x41, 0x41,	/* [ */
+    0x02, 0x04, 0x08, 0x10, 0x20,	/* backslash */
+    0x00, 0x41, 0x41, 0x41, 0x7f,	/* ] */
+    0x04, 0x02, 0x01, 0x02, 0x04,	/* ^ */
+    0x40, 0x40, 0x40, 0x40, 0x40,	/* _ */
+    0x00, 0x03, 0x07, 0x08, 0x00,	/* ` */
+    0x20, 0x54, 0x54, 0x78, 0x40,	/* a */
+    0x7f, 0x28, 0x44, 0x44, 0x38,	/* b */
+    0x38, 0x44, 0x44, 0x44, 0x28,	/* c */
+    0x38, 0x44, 0x44, 0x28, 0x7f,	/* d */
+    0x38, 0x54, 0x54, 0x54, 0x18,	/* e */
+    0x00, 0x08, 0x7e, 0x09, 0x02,	/* f */
+    0x18, 0xa4, 0xa4, 0x9c, 0x78,	/* g */
+    0x7f, 0x08, 0x04, 0x04, 0x78,	/* h */
+    0x00, 0x44, 0x7d, 0x40, 0x00,	/* i */
+    0x20, 0x40, 0x40, 0x3d, 0x00,	/* j */
+    0x7f, 0x10, 0x28, 0x44, 0x00,	/* k */
+    0x00, 0x41, 0x7f, 0x40, 0x00,	/* l */
+    0x7c, 0x04, 0x78, 0x04, 0x78,	/* m */
+    0x7c, 0x08, 0x04, 0x04, 0x78,	/* n */
+    0x38, 0x44, 0x44, 0x44, 0x38,	/* o */
+    0xfc, 0x18, 0x24, 0x24, 0x18,	/* p */
+    0x18, 0x24, 0x24, 0x18, 0xfc,	/* q */
+    0x7c, 0x08, 0x04, 0x04, 0x08,	/* r */
+    0x48, 0x54, 0x54, 0x54, 0x24,	/* s */
+    0x04, 0x04, 0x3f, 0x44, 0x24,	/* t */
+    0x3c, 0x40, 0x40, 0x20, 0x7c,	/* u */
+    0x1c, 0x20, 0x40, 0x20, 0x1c,	/* v */
+    0x3c, 0x40, 0x30, 0x40, 0x3c,	/* w */
+    0x44, 0x28, 0x10, 0x28, 0x44,	/* x */
+    0x4c, 0x90, 0x90, 0x90, 0x7c,	/* y */
+    0x44, 0x64, 0x54, 0x4c, 0x44,	/* z */
+    0x00, 0x08, 0x36, 0x41, 0x00,	/* { */
+    0x00, 0x00, 0x77, 0x00, 0x00,	/* | */
+    0x00, 0x41, 0x36, 0x08, 0x00,	/* } */
+    0x02, 0x01, 0x02, 0x04, 0x02,	/* ~ */
+};
+
+static void m7fb_all(char, char);
+static void m7fb_row(char);
+static void m7fb_send(char);
+static void m7fb_end(void);
+static char m7fb_code(char);
+static void m7fb_render(void);
+static void m7fb_shift(char);
+static void m7fb_turn(const char *, char);
+
+/******************************************************************************
+ *
+ *  Initialize SPI and chain, clear display
+ *  in: number of modules, M7FB_RAW or M7FB_CODE_B
+ */
+
+void m7fb_init(char count, char decode)
+{
+    char	digit, mod;
+
+    if (count > M7FB_MAX)
+	count = M7FB_MAX;
+    m7fb_count = count;
+
+    M7FB_CS_ODR |= M7FB_CS_MASK;	/* LOAD idles high */
+    M7FB_CS_DDR |= M7FB_CS_MASK;
+    M7FB_CS_CR1 |= M7FB_CS_MASK;
+    PC_DDR |= 0x60;		/* clock and MOSI are outputs */
+    PC_CR1 |= 0x60;		/* push-pull */
+    PC_CR2 |= 0x60;		/* fast */
+
+    SPI_ICR = 0;
+    SPI_CR1 = 0;
+    SPI_CR2 = CR2_BDM | CR2_BDOE | CR2_SSM | CR2_SSI;	/* TX only */
+    SPI_CR1 = CR1_MSTR | CR1_4MHZ;	/* MSB first, mode 0 */
+    SPI_CR1 |= CR1_SPE;
+
+    m7fb_all(REG_TEST, 0);
+    m7fb_all(REG_SCAN, 7);
+    m7fb_all(REG_DECODE, decode);
+    m7fb_all(REG_INTENSITY, 8);
+    m7fb_all(REG_SHUTDOWN, 1);
+
+    for (digit = 0; digit < 8; digit++)
+	for (mod = 0; mod < count; mod++)
+	    m7fb_buf[digit][mod] = decode ? CODE_BLANK : 0;
+    for (digit = 0; digit < 8; digit++) {
+	m7fb_dirty[digit] = 0xffff;
+	m7fb_row(digit);
+    }
+}
+
+/******************************************************************************
+ *
+ *  Set brightness of all modules
+ *  in: intensity 0-15
+ */
+
+void m7fb_bright(char level)
+{
+    m7fb_all(REG_INTENSITY, level & 15);
+}
+
+/******************************************************************************
+ *
+ *  Set one digit register in the framebuffer
+ *  in: module, digit 0-7, data
+ */
+
+void m7fb_set(char mod, char digit, char data)
+{
+    if (m7fb_buf[digit][mod] == data)
+	return;
+    m7fb_buf[digit][mod] = data;
+    m7fb_dirty[digit] |= (uint16_t)1 << mod;
+}
+
+/******************************************************************************
+ *
+ *  Get one digit register from the framebuffer
+ *  in: module, digit 0-7
+ *  out: data
+ */
+
+char m7fb_get(char mod, char digit)
+{
+    return m7fb_buf[digit][mod];
+}
+
+/******************************************************************************
+ *
+ *  Put string on a Code-B module
+ *  in: module, position from the left (0-7), string
+ */
+
+void m7fb_puts(char mod, char pos, char *str)
+{
+    char	digit, code;
+
+    digit = 8 - pos;		/* digit + 1 of first character */
+    while (*str && digit) {
+	code = m7fb_code(*str++);
+	if (*str == '.') {
+	    code |= CODE_DP;
+	    str++;
+	}
+	m7fb_set(mod, --digit, code);
+    }
+}
+
+/******************************************************************************
+ *
+ *  Send changed rows to the chain
+ *  out: number of rows sent (0-8)
+ */
+
+char m7fb_flush(void)
+{
+    char	digit, rows;
+
+    rows = 0;
+    for (digit = 0; digit < 8; digit++) {
+	if (!m7fb_dirty[digit])
+	    continue;
+	m7fb_row(digit);
+	rows++;
+    }
+    return rows;
+}
+
+/******************************************************************************
+ *
+ *  Copy column bitmap to whole chain and send it
+ *  in: columns, one byte each with bit 0 on top, leftmost first
+ */
+
+void m7fb_blit(const char *cols)
+{
+    char	digit, mod;
+
+    mod = m7fb_count;
+    while (mod--) {		/* leftmost module first */
+	m7fb_turn(cols, mod);
+	cols += 8;
+    }
+    for (digit = 0; digit < 8; digit++) {
+	m7fb_dirty[digit] = 0xffff;
+	m7fb_row(digit);
+    }
+}
+
+/******************************************************************************
+ *
+ *  Turn 8 columns into the 8 row registers of one module
+ *  in: columns, module
+ */
+
+static void m7fb_turn(const char *cols, char mod)
+{
+    char	rows[8];
+    char	i, digit, col;
+
+    for (i = 0; i < 8; i++) {
+	col = *cols++;
+	for (digit = 0; digit < 8; digit++) {
+	    rows[digit] = (rows[digit] << 1) | (col & 1);	/* 8 shifts */
+	    col >>= 1;
+	}
+    }
+    for (digit = 0; digit < 8; digit++)
+	m7fb_buf[digit][mod] = rows[digit];
+}
+
+/******************************************************************************
+ *
+ *  Start or stop marquee on dot matrix modules
+ *  in: string (zero to stop), timer ticks per column
+ */
+
+void m7fb_marquee(const char *str, char rate)
+{
+    m7fb_mrun = 0;
+    if (!str || !*str || !rate)
+	return;
+    m7fb_mstr = str;
+    m7fb_mptr = str;
+    m7fb_mrate = rate;
+    m7fb_mwait = rate;
+    m7fb_ring_in = 0;
+    m7fb_ring_out = 0;
+    m7fb_render();
+    m7fb_mrun = 1;
+}
+
+/******************************************************************************
+ *
+ *  Marquee timer tick, call from timer interrupt
+ */
+
+void m7fb_tick(void)
+{
+    if (!m7fb_mrun)
+	return;
+    if (--m7fb_mwait)
+	return;
+    m7fb_mwait = m7fb_mrate;
+
+    if ((char)(m7fb_ring_in - m7fb_ring_out) <= RING_SIZE - 6)
+	m7fb_render();		/* stay a character ahead */
+    m7fb_shift(m7fb_ring[m7fb_ring_out & RING_MASK]);
+    m7fb_ring_out++;
+    m7fb_flush();
+}
+
+/******************************************************************************
+ *
+ *  Render next marquee character into the ring
+ */
+
+static void m7fb_render(void)
+{
+    const char	*font;
+    char	c, i;
+
+    c = *m7fb_mptr++;
+    if (!*m7fb_mptr)
+	m7fb_mptr = m7fb_mstr;
+    if (c < ' ' || c > '~')
+	c = ' ';
+    font = m7fb_font + (c - ' ') * 5;
+
+    for (i = 0; i < 5; i++)
+	m7fb_ring[m7fb_ring_in++ & RING_MASK] = *font++;
+    m7fb_ring[m7fb_ring_in++ & RING_MASK] = 0;
+}
+
+/******************************************************************************
+ *
+ *  Shift display left one column
+ *  in: new right column, bit 0 on top
+ */
+
+static void m7fb_shift(char col)
+{
+    char	digit, mod, carry, data;
+
+    for (digit = 0; digit < 8; digit++) {
+	carry = col & 1;
+	col >>= 1;
+	for (mod = 0; mod < m7fb_count; mod++) {	/* right to left */
+	    data = m7fb_buf[digit][mod];
+	    m7fb_set(mod, digit, (data << 1) | carry);
+	    carry = data >> 7;
+	}
+    }
+}
+
+/******************************************************************************
+ *
+ *  Write one control register in every module
+ *  in: register, data
+ */
+
+static void m7fb_all(char reg, char data)
+{
+    char	mod;
+
+    M7FB_CS_ODR &= ~M7FB_CS_MASK;
+    for (mod = 0; mod < m7fb_count; mod++) {
+	m7fb_send(reg);
+	m7fb_send(data);
+    }
+    m7fb_end();
+}
+
+/******************************************************************************
+ *
+ *  Send one digit row, no-op for modules that did not change
+ *  in: digit 0-7
+ */
+
+static void m7fb_row(char digit)
+{
+    uint16_t	dirty;
+    char	mod;
+
+    dirty = m7fb_dirty[digit];
+    m7fb_dirty[digit] = 0;
+
+    M7FB_CS_ODR &= ~M7FB_CS_MASK;
+    mod = m7fb_count;
+    while (mod--) {		/* farthest module first */
+	if (dirty & ((uint16_t)1 << mod)) {
+	    m7fb_send(REG_DIGIT0 + digit);
+	    m7fb_send(m7fb_buf[digit][mod]);
+	}
+	else {
+	    m7fb_send(REG_NOOP);
+	    m7fb_send(0);
+	}
+    }
+    m7fb_end();
+}
+
+/******************************************************************************
+ *
+ *  Send one byte
+ *  in: byte
+ */
+
+static void m7fb_send(char data)
+{
+    while (!(SPI_SR & SR_TXE));
+    SPI_DR = data;
+}
+
+/******************************************************************************
+ *
+ *  Wait for last byte, then latch with rising LOAD
+ */
+
+static void m7fb_end(void)
+{
+    while (!(SPI_SR & SR_TXE));
+    while (SPI_SR & SR_BSY);
+    M7FB_CS_ODR |= M7FB_CS_MASK;
+}
+
+/******************************************************************************
+ *
+ *  Convert character to Code-B
+ *  in: character
+ *  out: Code-B value (blank if not available)
+ */
+
+static char m7fb_code(char c)
+{
+    if (c >= '0' && c <= '9')
+	return c - '0';
+    switch (c) {
+    case '-':
+	return CODE_DASH;
+    case 'E':
+	return CODE_E;
+    case 'H':
+	return CODE_H;
+    case 'L':
+	return CODE_L;
+    case 'P':
+	return CODE_P;
+    }
+    return CODE_BLANK;
+}
@@ -0,0 +1,136 @@
+/*
+ *  File name:  lib_m7219fb.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: MAX7219 chain with shadow framebuffer, on hardware SPI.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Writes only go to a RAM copy of every digit register in the chain.
+ *  m7fb_flush() then sends the digit rows that changed, one chip select
+ *  cycle per row, with no-op writes for the modules in that row that
+ *  did not change. Rows with no changes are not sent at all, so a clock
+ *  that changes one digit per second costs one row, not eight.
+ *
+ *  Module 0 is the one wired to the STM8. Digit n is digit register
+ *  n+1, which is the top row of a dot matrix module, and the rightmost
+ *  digit of the usual 8-digit 7-segment module.
+ *
+ *  Dot matrix modules are taken to be the common FC-16 kind: module 0
+ *  is the rightmost, and bit 7 of a row is its left column.
+ *
+ *  The marquee runs in the background from m7fb_tick(), which is called
+ *  from a timer interrupt. It renders the string a character ahead into
+ *  a ring of columns, and shifts the display one column at a time.
+ *  While it runs, the timer owns the display, so the main program must
+ *  not call the other m7fb_ routines until m7fb_marquee(0, 0).
+ *
+ *  Pins: CLK on C5 (SPI clock), DIN on C6 (MOSI), LOAD on C4 (M7FB_CS_).
+ *  This library uses the SPI without interrupts. Do not use it in the
+ *  same program as lib_spi or lib_spiq.
+ */
+
+#ifndef M7FB_MAX
+#define M7FB_MAX	16	/* most modules in chain */
+#endif
+#if M7FB_MAX > 16
+#error M7FB_MAX over 16: the dirty masks are one 16 bit word per digit
+#endif
+
+#ifndef M7FB_CS_ODR
+#define M7FB_CS_ODR	PC_ODR	/* LOAD pin, default C4 */
+#define M7FB_CS_DDR	PC_DDR
+#define M7FB_CS_CR1	PC_CR1
+#define M7FB_CS_MASK	0x10
+#endif
+
+#define M7FB_RAW	0x00	/* segment bits as written */
+#define M7FB_CODE_B	0xff	/* MAX7219 decodes 0-9 - E H L P blank */
+
+/******************************************************************************
+ *
+ *  Initialize SPI and chain, clear display
+ *  in: number of modules, M7FB_RAW or M7FB_CODE_B
+ */
+
+void m7fb_init(char, char);
+
+/******************************************************************************
+ *
+ *  Set brightness of all modules
+ *  in: intensity 0-15
+ */
+
+void m7fb_bright(char);
+
+/******************************************************************************
+ *
+ *  Set one digit register in the framebuffer
+ *  in: module, digit 0-7, data
+ */
+
+void m7fb_set(char, char, char);
+
+/******************************************************************************
+ *
+ *  Get one digit register from the framebuffer
+ *  in: module, digit 0-7
+ *  out: data
+ */
+
+char m7fb_get(char, char);
+
+/******************************************************************************
+ *
+ *  Put string on a Code-B module
+ *  in: module, position from the left (0-7), string
+ *
+ *  Handles 0-9, space, - E H L P, and '.' for the decimal point of the
+ *  character before it. Stops at the end of the string or the module.
+ */
+
+void m7fb_puts(char, char, char *);
+
+/******************************************************************************
+ *
+ *  Send changed rows to the chain
+ *  out: number of rows sent (0-8)
+ */
+
+char m7fb_flush(void);
+
+/******************************************************************************
+ *
+ *  Copy column bitmap to whole chain and send it
+ *  in: columns, one byte each with bit 0 on top, leftmost first
+ *
+ *  Takes 8 columns per module in the chain. All rows are sent, one
+ *  chip select cycle per row for the whole chain, without no-ops.
+ */
+
+void m7fb_blit(const char *);
+
+/******************************************************************************
+ *
+ *  Start or stop marquee on dot matrix modules
+ *  in: string (zero to stop), timer ticks per column
+ *
+ *  The string repeats until stopped. It must stay valid while it runs.
+ */
+
+void m7fb_marquee(const char *, char);
+
+/******************************************************************************
+ *
+ *  Marquee timer tick, call from timer interrupt
+ *
+ *  Each column step sends the whole chain, about 40 usec per module.
+ */
+
+void m7fb_tick(void);
@@ -0,0 +1,136 @@
+/*
+ *  File name:  lib_pingd.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Range finder counts to distance, without divides.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Speed is in mm/sec. One count (1/2 usec, round trip) is speed / 4e6
+ *  mm one way, so the scale for mm is speed * 2^19 / 4e6. The scales are
+ *  rounded down, so a result is never above the exact distance.
+ *
+ *  pingd_scale() does the scale by shift and subtract, so even setting
+ *  the temperature does not need the 32 bit divide.
+ */
+
+#include <stdint.h>
+
+#include "lib_pingd.h"
+
+#define SHIFT_MM	19
+#define SHIFT_CM	22
+#define SHIFT_INCH	24
+
+#define DIV_MM		4000000UL	/* speed / DIV_MM is mm per count */
+#define DIV_CM		40000000UL
+#define DIV_INCH	101600000UL
+
+/* Scales for 20 C (343420 mm/sec) */
+
+static uint16_t	pingd_k_mm = 45012;
+static uint16_t	pingd_k_cm = 36010;
+static uint16_t	pingd_k_inch = 56708;
+
+static uint16_t pingd_scale(uint32_t, char, uint32_t);
+static uint16_t pingd_mulhi(uint16_t, uint16_t);
+
+/******************************************************************************
+ *
+ *  Set speed of sound for temperature
+ *  in: celsius (PINGD_TEMP_MIN to PINGD_TEMP_MAX)
+ */
+
+void pingd_temp(signed char temp)
+{
+    uint32_t	speed;
+
+    if (temp < PINGD_TEMP_MIN)
+	temp = PINGD_TEMP_MIN;
+    if (temp > PINGD_TEMP_MAX)
+	temp = PINGD_TEMP_MAX;
+    speed = 331300 + 606L * temp;
+
+    pingd_k_mm = pingd_scale(speed, SHIFT_MM, DIV_MM);
+    pingd_k_cm = pingd_scale(speed, SHIFT_CM, DIV_CM);
+    pingd_k_inch = pingd_scale(speed, SHIFT_INCH, DIV_INCH);
+}
+
+/******************************************************************************
+ *
+ *  Convert round trip to distance
+ *  in: counts
+ *  out: millimeters, centimeters, or inches
+ */
+
+uint16_t pingd_mm(uint16_t count)
+{
+    return pingd_mulhi(count, pingd_k_mm) >> (SHIFT_MM - 16);
+}
+
+uint16_t pingd_cm(uint16_t count)
+{
+    return pingd_mulhi(count, pingd_k_cm) >> (SHIFT_CM - 16);
+}
+
+uint16_t pingd_inch(uint16_t count)
+{
+    return pingd_mulhi(count, pingd_k_inch) >> (SHIFT_INCH - 16);
+}
+
+/******************************************************************************
+ *
+ *  Scale, speed * 2^shift / div, rounded down
+ *  in: speed, shift, divisor (more than speed, less than 2^31)
+ *  out: scale
+ */
+
+static uint16_t pingd_scale(uint32_t speed, char shift, uint32_t div)
+{
+    uint32_t	rem;
+    uint16_t	scale;
+
+    scale = 0;
+    rem = speed;
+    while (shift--) {
+	scale <<= 1;
+	rem <<= 1;
+	if (rem >= div) {
+	    rem -= div;
+	    scale |= 1;
+	}
+    }
+    return scale;
+}
+
+/******************************************************************************
+ *
+ *  High 16 bits of 16x16 multiply, from four 8x8 multiplies
+ *  in: two numbers
+ *  out: (a * b) >> 16
+ */
+
+static uint16_t pingd_mulhi(uint16_t a, uint16_t b)
+{
+    uint16_t	lo, mid1, mid2, hi;
+    char	al, ah, bl, bh;
+
+    al = a;
+    ah = a >> 8;
+    bl = b;
+    bh = b >> 8;
+
+    lo   = (uint16_t)al * bl;
+    mid1 = (uint16_t)al * bh;
+    mid2 = (uint16_t)ah * bl;
+    hi   = (uint16_t)ah * bh;
+
+    lo = (lo >> 8) + (mid1 & 0xff) + (mid2 & 0xff);	/* carry into hi */
+    return hi + (mid1 >> 8) + (mid2 >> 8) + (lo >> 8);
+}
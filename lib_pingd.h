@@ -0,0 +1,49 @@
+/*
+ *  File name:  lib_pingd.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Range finder counts to distance, without divides.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Input is the round trip in lib_pingx counts (1/2 usec). Each unit
+ *  has a 16 bit scale, and a distance is (count * scale) >> shift,
+ *  done as four 8x8 multiplies (the STM8 MUL instruction).
+ *
+ *  The scales follow the speed of sound, 331.3 + 0.606 * T m/s. They
+ *  start at 20 C, and pingd_temp() sets them for another temperature.
+ *  That has the only divides, so call it when the temperature changes,
+ *  not for every reading.
+ *
+ *  Results are rounded down, and are never more than one unit below
+ *  the exact distance (checked for every count and temperature by
+ *  host/test_pingd_host.c).
+ */
+
+#define PINGD_TEMP_MIN	-40	/* celsius */
+#define PINGD_TEMP_MAX	85
+
+/******************************************************************************
+ *
+ *  Set speed of sound for temperature
+ *  in: celsius (PINGD_TEMP_MIN to PINGD_TEMP_MAX)
+ */
+
+void pingd_temp(signed char);
+
+/******************************************************************************
+ *
+ *  Convert round trip to distance
+ *  in: counts (not PINGX_NONE)
+ *  out: millimeters, centimeters, or inches
+ */
+
+uint16_t pingd_mm(uint16_t);
+uint16_t pingd_cm(uint16_t);
+uint16_t pingd_inch(uint16_t);
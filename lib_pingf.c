@@ -0,0 +1,138 @@
+/*
+ *  File name:  lib_pingf.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Median and average filter for range finder results.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  The median sorts a copy of the history by insertion, which is at
+ *  most 10 compares for 5 samples. The average step rounds away from
+ *  the old value, so it always reaches a steady input exactly.
+ *
+ *  Outliers only count toward a new level while they agree with each
+ *  other (within jump of the first one), so scattered false echoes that
+ *  get past the median do not add up to a step.
+ */
+
+#include <stdint.h>
+
+#include "lib_pingf.h"
+
+static uint16_t pingf_median(PINGF *);
+static uint16_t pingf_diff(uint16_t, uint16_t);
+
+/******************************************************************************
+ *
+ *  Set up filter
+ *  in: filter, average shift (0-7), outlier distance
+ */
+
+void pingf_init(PINGF *f, char shift, uint16_t jump)
+{
+    f->shift = shift;
+    f->jump = jump;
+    f->count = 0;
+    f->pos = 0;
+    f->outliers = 0;
+    f->misses = 0;
+    f->avg = PINGF_NONE;
+}
+
+/******************************************************************************
+ *
+ *  Add result to filter
+ *  in: filter, result or PINGF_NONE
+ *  out: filtered value, or PINGF_NONE
+ */
+
+uint16_t pingf_add(PINGF *f, uint16_t val)
+{
+    uint16_t	med, diff, step;
+
+    if (val == PINGF_NONE) {
+	if (++f->misses < PINGF_MEDIAN)
+	    return f->avg;
+	f->misses = 0;
+	f->count = 0;		/* start over */
+	f->pos = 0;
+	f->outliers = 0;
+	f->avg = PINGF_NONE;
+	return PINGF_NONE;
+    }
+    f->misses = 0;
+
+    f->hist[f->pos] = val;
+    if (++f->pos == PINGF_MEDIAN)
+	f->pos = 0;
+    if (f->count < PINGF_MEDIAN)
+	f->count++;
+    med = pingf_median(f);
+
+    if (f->avg == PINGF_NONE) {
+	f->avg = med;
+	return med;
+    }
+
+    diff = pingf_diff(med, f->avg);
+    if (diff > f->jump) {
+	if (!f->outliers || pingf_diff(med, f->cand) > f->jump) {
+	    f->cand = med;	/* new candidate level */
+	    f->outliers = 1;
+	    return f->avg;
+	}
+	if (++f->outliers < PINGF_HOLD)
+	    return f->avg;	/* hold off */
+	f->outliers = 0;
+	f->avg = med;		/* distance really changed */
+	return med;
+    }
+    f->outliers = 0;
+
+    step = diff >> f->shift;
+    if (diff & ((1 << f->shift) - 1))
+	step++;			/* round up */
+    if (med > f->avg)
+	f->avg += step;
+    else
+	f->avg -= step;
+    return f->avg;
+}
+
+/******************************************************************************
+ *
+ *  Median of history
+ *  in: filter
+ *  out: median (lower middle while filling with an even count)
+ */
+
+static uint16_t pingf_median(PINGF *f)
+{
+    uint16_t	sort[PINGF_MEDIAN];
+    uint16_t	val;
+    uint8_t	i, j;
+
+    for (i = 0; i < f->count; i++) {
+	val = f->hist[i];
+	for (j = i; j && sort[j - 1] > val; j--)
+	    sort[j] = sort[j - 1];
+	sort[j] = val;
+    }
+    return sort[(f->count - 1) >> 1];
+}
+
+/******************************************************************************
+ *
+ *  Distance between two values
+ */
+
+static uint16_t pingf_diff(uint16_t a, uint16_t b)
+{
+    return a > b ? a - b : b - a;
+}
@@ -0,0 +1,65 @@
+/*
+ *  File name:  lib_pingf.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Median and average filter for range finder results.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Each channel has its own PINGF. A result goes through a running
+ *  median of PINGF_MEDIAN, which drops a short burst of false echoes,
+ *  then an exponential average with weight 1/2^shift. There are no
+ *  divides, so it is cheap enough for the ping callback.
+ *
+ *  A median farther than "jump" from the average is held off as an
+ *  outlier. PINGF_HOLD of them in a row, all near each other, are taken
+ *  as a real change of distance, and the average starts from there.
+ *
+ *  Missing echoes (PINGF_NONE) are skipped, and the last value is kept.
+ *  After PINGF_MEDIAN of them in a row the filter starts over, and gives
+ *  PINGF_NONE until there is a new echo.
+ *
+ *  Shift 0 turns the average off (median only). Jump 0xffff turns the
+ *  outlier check off.
+ *
+ *  Host test: host/test_pingf_host.c
+ */
+
+#define PINGF_MEDIAN	5	/* samples in median */
+#define PINGF_HOLD	5	/* outliers in a row to accept */
+#define PINGF_NONE	0xffff	/* no echo, or no value yet */
+
+typedef struct {
+    uint16_t	hist[PINGF_MEDIAN];	/* last results, ring */
+    uint16_t	avg;		/* filtered value */
+    uint16_t	jump;		/* outlier distance */
+    uint16_t	cand;		/* first outlier of a run */
+    char	shift;		/* average weight 1/2^shift */
+    uint8_t	count;		/* results in hist */
+    uint8_t	pos;		/* next hist slot */
+    char	outliers;	/* in a row */
+    char	misses;		/* missing echoes in a row */
+} PINGF;
+
+/******************************************************************************
+ *
+ *  Set up filter
+ *  in: filter, average shift (0-7), outlier distance
+ */
+
+void pingf_init(PINGF *, char, uint16_t);
+
+/******************************************************************************
+ *
+ *  Add result to filter
+ *  in: filter, result or PINGF_NONE
+ *  out: filtered value, or PINGF_NONE
+ */
+
+uint16_t pingf_add(PINGF *, uint16_t);
@@ -0,0 +1,311 @@
+/*
+ *  File name:  lib_pingx.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Interrupt-scheduled HC-SR04 ultrasonic range finders.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  One channel is active at a time. Timer 2 counts from its trigger,
+ *  and the auto-reload is the deadline for whatever comes next: the
+ *  echo timeout while waiting for the echo, then the end of the gap.
+ *  The update interrupt at the deadline fires the next trigger.
+ *
+ *  The echo is timed by input capture on the active channel. The timer
+ *  latches the count at the rising edge, the interrupt flips the
+ *  polarity, and the timer latches the falling edge. Interrupt latency
+ *  only has to be shorter than the echo; it is not in the result.
+ */
+
+#include "stm8s_header.h"
+
+#include "lib_pingx.h"
+
+#define ST_IDLE		0	/* stopped */
+#define ST_RISE		1	/* triggered, waiting for echo */
+#define ST_FALL		2	/* echo started, waiting for end */
+#define ST_GAP		3	/* result sent, waiting for gap */
+
+#define PINGX_PULSE	(10 * PINGX_TICKS)	/* trigger pulse */
+#define PINGX_MARGIN	(20 * PINGX_TICKS)	/* shorter wait triggers now */
+#define PINGX_WAIT	((uint16_t)PINGX_TIMEOUT * PINGX_TICKS)
+
+#define CCMR_INPUT	0x31	/* CCxS input TIx, filter 8 clocks */
+#define IER_UIE		0x01
+
+/* Capture registers of each channel */
+
+static volatile char * const pingx_ccer[PINGX_CHANS] = {
+    &TIM2_CCER1, &TIM2_CCER1, &TIM2_CCER2
+};
+static const char pingx_cce[PINGX_CHANS] = {	/* enable, polarity is next bit */
+    0x01, 0x10, 0x01
+};
+static const char pingx_ccif[PINGX_CHANS] = {	/* SR1 flag, IER enable */
+    0x02, 0x04, 0x08
+};
+static volatile char * const pingx_ccr[PINGX_CHANS] = {	/* high, then low */
+    &TIM2_CCR1H, &TIM2_CCR2H, &TIM2_CCR3H
+};
+
+static const IO_CALL_INT *pingx_cfg;
+static char	pingx_count;		/* channels in use */
+static char	pingx_chan;		/* active channel */
+static volatile char pingx_state;
+static volatile char pingx_run;		/* keep going after this ping */
+static uint16_t	pingx_rise;		/* time echo started */
+static uint16_t	pingx_gap_ticks;
+
+static void pingx_trigger(void);
+static void pingx_done(int, uint16_t);
+static void pingx_deadline(uint16_t);
+static uint16_t pingx_read(void);
+static uint16_t pingx_capture(char);
+
+/******************************************************************************
+ *
+ *  Initialize timer and echo pins
+ *  in: number of channels, trigger pins and callbacks
+ */
+
+void pingx_init(char count, const IO_CALL_INT *cfg)
+{
+    if (count > PINGX_CHANS)
+	count = PINGX_CHANS;
+    pingx_count = count;
+    pingx_cfg = cfg;
+    pingx_chan = 0;
+    pingx_state = ST_IDLE;
+    pingx_run = 0;
+    pingx_gap(PINGX_GAP);
+
+    TIM2_CR1 = 0;
+    TIM2_IER = 0;
+    TIM2_PSCR = 3;		/* 2 counts per usec at 16 mhz */
+    TIM2_CCER1 = 0;		/* capture off while CCxS is set */
+    TIM2_CCER2 = 0;
+    TIM2_CCMR1 = CCMR_INPUT;
+    TIM2_CCMR2 = CCMR_INPUT;
+    TIM2_CCMR3 = CCMR_INPUT;
+
+    PD_DDR &= ~0x18;		/* D4, D3 are floating inputs */
+    PD_CR1 &= ~0x18;
+    PA_DDR &= ~0x08;		/* A3 is floating input */
+    PA_CR1 &= ~0x08;
+}
+
+/******************************************************************************
+ *
+ *  Set shortest time between triggers
+ *  in: microseconds
+ */
+
+void pingx_gap(uint16_t usecs)
+{
+    if (usecs > 0xffff / PINGX_TICKS)
+	usecs = 0xffff / PINGX_TICKS;
+    pingx_gap_ticks = usecs * PINGX_TICKS;
+}
+
+/******************************************************************************
+ *
+ *  Start pinging the channels in turn
+ */
+
+void pingx_start(void)
+{
+    if (!pingx_count)
+	return;
+    pingx_run = 1;
+    if (pingx_state != ST_IDLE)
+	return;			/* stop was asked, but not done yet */
+    pingx_trigger();
+}
+
+/******************************************************************************
+ *
+ *  Stop after the ping in progress
+ */
+
+void pingx_stop(void)
+{
+    pingx_run = 0;
+}
+
+/******************************************************************************
+ *
+ *  Send trigger pulse on active channel, start timing
+ */
+
+static void pingx_trigger(void)
+{
+    const IO_PIN *pin;
+    volatile char *ccer;
+    char	cce, chan;
+
+    chan = pingx_chan;
+    pin = pingx_cfg[chan].pin;
+    ccer = pingx_ccer[chan];
+    cce = pingx_cce[chan];
+
+    TIM2_CCER1 = 0;		/* capture on active channel only, */
+    TIM2_CCER2 = 0;
+    *ccer = cce;		/* on rising edge */
+    TIM2_IER = IER_UIE | pingx_ccif[chan];
+
+    TIM2_ARRH = PINGX_WAIT >> 8;
+    TIM2_ARRL = PINGX_WAIT & 0xff;
+    TIM2_EGR = 1;		/* clear counter */
+    TIM2_SR1 = 0;		/* and the update from EGR */
+    TIM2_CR1 = 1;
+
+    *pin->port |= pin->mask;
+    while (pingx_read() < PINGX_PULSE);
+    *pin->port &= ~pin->mask;
+
+    pingx_state = ST_RISE;
+}
+
+/******************************************************************************
+ *
+ *  Ping is finished: schedule next one, send result
+ *  in: result, counts to wait before next trigger
+ */
+
+static void pingx_done(int val, uint16_t wait)
+{
+    char	chan;
+
+    chan = pingx_chan;
+    pingx_chan++;
+    if (pingx_chan == pingx_count)
+	pingx_chan = 0;
+
+    if (!pingx_run) {
+	TIM2_CR1 = 0;
+	TIM2_IER = 0;
+	TIM2_CCER1 = 0;
+	TIM2_CCER2 = 0;
+	pingx_state = ST_IDLE;
+    }
+    else if (wait)
+	pingx_deadline(wait);
+    else
+	pingx_trigger();
+
+    pingx_cfg[chan].call(val);
+}
+
+/******************************************************************************
+ *
+ *  Set update interrupt for time from now
+ *  in: counts
+ */
+
+static void pingx_deadline(uint16_t wait)
+{
+    wait += pingx_read();
+    TIM2_ARRH = wait >> 8;
+    TIM2_ARRL = wait;
+    TIM2_IER = IER_UIE;
+    pingx_state = ST_GAP;
+}
+
+/******************************************************************************
+ *
+ *  Read timer count
+ */
+
+static uint16_t pingx_read(void)
+{
+    uint16_t	count;
+
+    count = TIM2_CNTRH << 8;	/* reading high byte latches low byte */
+    count |= TIM2_CNTRL;
+    return count;
+}
+
+/******************************************************************************
+ *
+ *  Read captured count of channel (clears its flag)
+ *  in: channel
+ */
+
+static uint16_t pingx_capture(char chan)
+{
+    volatile char *ccr;
+    uint16_t	count;
+
+    ccr = pingx_ccr[chan];
+    count = ccr[0] << 8;
+    count |= ccr[1];
+    return count;
+}
+
+/******************************************************************************
+ *
+ *  Timer 2 capture interrupt, echo edges of active channel
+ */
+
+void pingx_capture_isr(void) __interrupt (IRQ_TIM2_CC)
+{
+    uint16_t	now;
+    char	chan;
+
+    chan = pingx_chan;
+    if (!(TIM2_SR1 & pingx_ccif[chan]))
+	return;
+    now = pingx_capture(chan);
+    TIM2_SR2 = 0;		/* clear overcapture */
+
+    if (pingx_state == ST_RISE) {
+	pingx_rise = now;
+	*pingx_ccer[chan] = pingx_cce[chan] * 3;	/* now falling edge */
+	pingx_state = ST_FALL;
+	return;
+    }
+    if (pingx_state != ST_FALL)
+	return;
+
+    *pingx_ccer[chan] = 0;
+    if (now + PINGX_MARGIN < pingx_gap_ticks)
+	pingx_done(now - pingx_rise, pingx_gap_ticks - now);
+    else
+	pingx_done(now - pingx_rise, 0);
+}
+
+/******************************************************************************
+ *
+ *  Timer 2 update interrupt, at echo timeout or end of gap
+ *  After the timeout the counter starts again from zero.
+ */
+
+void pingx_timer_isr(void) __interrupt (IRQ_TIM2)
+{
+    TIM2_SR1 = ~IER_UIE;	/* clear the interrupt (same bit as UIF) */
+
+    if (pingx_state == ST_GAP) {
+	if (pingx_run)
+	    pingx_trigger();
+	else {
+	    TIM2_CR1 = 0;
+	    TIM2_IER = 0;
+	    pingx_state = ST_IDLE;
+	}
+	return;
+    }
+    if (pingx_state == ST_IDLE)
+	return;
+
+    *pingx_ccer[pingx_chan] = 0;
+    if (pingx_gap_ticks > PINGX_WAIT + PINGX_MARGIN)
+	pingx_done(PINGX_NONE, pingx_gap_ticks - PINGX_WAIT);
+    else
+	pingx_done(PINGX_NONE, 0);
+}
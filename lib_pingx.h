@@ -0,0 +1,90 @@
+/*
+ *  File name:  lib_pingx.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Interrupt-scheduled HC-SR04 ultrasonic range finders.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Once started, the channels are pinged in turn with no help from the
+ *  main loop. The end of each echo, or the echo timeout, schedules the
+ *  next trigger, so the next sensor fires as soon as it is safe to.
+ *
+ *  Timer 2 times the echo by input capture, to half a microsecond, and
+ *  keeps the gap: the next trigger is at least the gap time after the
+ *  last one, so a late echo from one sensor is not heard by the next.
+ *  With short echoes the update rate is set by the gap alone, and it
+ *  does not change with the number of channels.
+ *
+ *  Results go to the channel callbacks from interrupt context, in
+ *  timer counts (PINGX_TICKS per usec) of round trip, or PINGX_NONE if
+ *  there was no echo. The callback takes int, but the count is unsigned
+ *  and goes past 32767, so cast it to uint16_t.
+ *
+ *  Trigger pins are any outputs (set up by the caller). Echo pins are
+ *  the Timer 2 capture inputs: channel 0 is D4 (CH1), channel 1 is D3
+ *  (CH2), and channel 2 is A3 (CH3).
+ *
+ *  This library owns Timer 2. Do not use it in the same program as
+ *  lib_ping.
+ */
+
+#ifndef IRQ_TIM2
+#define IRQ_TIM2	13	/* Timer 2 update/overflow */
+#endif
+#ifndef IRQ_TIM2_CC
+#define IRQ_TIM2_CC	14	/* Timer 2 capture/compare */
+#endif
+
+#define PINGX_CHANS	3	/* most channels */
+#define PINGX_NONE	0xffff	/* no echo */
+#define PINGX_TICKS	2	/* timer counts per usec */
+
+#define PINGX_TIMEOUT	30000	/* usecs, longest echo (about 5 meters) */
+#define PINGX_GAP	25000	/* usecs, default trigger to next trigger */
+
+#define PINGX_INCH	296	/* counts round trip per inch */
+
+/******************************************************************************
+ *
+ *  Initialize timer and echo pins
+ *  in: number of channels, trigger pins and callbacks
+ */
+
+void pingx_init(char, const IO_CALL_INT *);
+
+/******************************************************************************
+ *
+ *  Set shortest time between triggers
+ *  in: microseconds (up to 32767)
+ */
+
+void pingx_gap(uint16_t);
+
+/******************************************************************************
+ *
+ *  Start pinging the channels in turn
+ */
+
+void pingx_start(void);
+
+/******************************************************************************
+ *
+ *  Stop after the ping in progress
+ */
+
+void pingx_stop(void);
+
+/******************************************************************************
+ *
+ *  Interrupts
+ */
+
+void pingx_timer_isr(void) __interrupt (IRQ_TIM2);
+void pingx_capture_isr(void) __interrupt (IRQ_TIM2_CC);
@@ -0,0 +1,294 @@
+/*
+ *  File name:  lib_spiq.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Queued, interrupt-driven SPI master library.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  The queue is a linked list through ctx->next. The head is the
+ *  transaction on the bus. When it finishes, the interrupt routine
+ *  deselects it, sets flag_done, and starts the next one right away.
+ *
+ *  Normal mode runs on RXNE: each received byte means the byte on the
+ *  bus is done, so the next one is written. During the RX phase,
+ *  SPIQ_FILL is sent to make the clocks. In duplex mode there is no RX
+ *  phase; the byte received for each TX byte is kept instead.
+ *
+ *  Bidirectional TX runs on TXE. Bidirectional RX clocks by itself once
+ *  BDOE is cleared, so the SPI is disabled one clock after the second
+ *  to last byte, as the reference manual asks.
+ */
+
+#include "stm8s_header.h"
+
+#include "lib_delay.h"
+#include "lib_spiq.h"
+
+/* SPI register bits */
+
+#define CR1_SPE		0x40
+#define CR1_MSTR	0x04
+#define CR2_BDM		0x80
+#define CR2_BDOE	0x40
+#define CR2_SSM		0x02
+#define CR2_SSI		0x01
+#define ICR_TXIE	0x80
+#define ICR_RXIE	0x40
+#define SR_BSY		0x80
+#define SR_TXE		0x02
+#define SR_RXNE		0x01
+
+static SPIQ_CTX * volatile spiq_head;	/* transaction on the bus */
+static SPIQ_CTX *spiq_tail;		/* last in queue */
+
+static char	*spiq_tx_ptr;
+static char	*spiq_rx_ptr;
+static char	spiq_tx_left;		/* bytes not yet written */
+static char	spiq_rx_left;		/* bytes not yet clocked in */
+static char	spiq_rx_flight;		/* byte on the bus is RX byte */
+static char	spiq_duplex;		/* keep bytes received during TX */
+static char	spiq_clock;		/* loop count for one SPI clock */
+
+static void spiq_begin(SPIQ_CTX *);
+static void spiq_next(void);
+static void spiq_bidir_rx(void);
+static void spiq_end(void);
+static void spiq_delay(char);
+
+/******************************************************************************
+ *
+ *  Initialize SPI and empty queue
+ */
+
+void spiq_init(void)
+{
+    spiq_head = 0;
+    spiq_tail = 0;
+
+    SPI_ICR = 0;
+    SPI_CR1 = 0;
+    PC_DDR |= 0x60;		/* clock and MOSI are outputs */
+    PC_CR1 |= 0x60;		/* push-pull */
+    PC_CR2 |= 0x60;		/* fast */
+}
+
+/******************************************************************************
+ *
+ *  Post transaction to end of queue
+ *  in: context
+ */
+
+void spiq_post(SPIQ_CTX *ctx)
+{
+    ctx->flag_done = 0;
+    ctx->next = 0;
+
+    __asm__ ("sim");
+    if (spiq_head) {
+	spiq_tail->next = ctx;
+	spiq_tail = ctx;
+    }
+    else {
+	spiq_head = ctx;
+	spiq_tail = ctx;
+	spiq_begin(ctx);
+    }
+    __asm__ ("rim");
+}
+
+/******************************************************************************
+ *
+ *  Check for pending transactions
+ */
+
+char spiq_busy(void)
+{
+    return spiq_head != 0;
+}
+
+/******************************************************************************
+ *
+ *  Wait for all posted transactions to finish
+ */
+
+void spiq_wait(void)
+{
+    while (spiq_head);
+}
+
+/******************************************************************************
+ *
+ *  Start transaction (interrupts are off)
+ *  in: context
+ */
+
+static void spiq_begin(SPIQ_CTX *ctx)
+{
+    SPI_ICR = 0;
+    SPI_CR1 = 0;		/* must be disabled to change config */
+    if (ctx->flag_bidir)
+	SPI_CR2 = CR2_BDM | CR2_BDOE | CR2_SSM | CR2_SSI;
+    else
+	SPI_CR2 = CR2_SSM | CR2_SSI;
+    SPI_CR1 = ctx->config | CR1_MSTR;
+    SPI_CR1 |= CR1_SPE;
+
+    spiq_clock = 1 << ((ctx->config & SPIQ_SPEED) >> 3);
+    spiq_tx_ptr = ctx->tx_buf;
+    spiq_rx_ptr = ctx->rx_buf;
+    spiq_tx_left = ctx->tx_count;
+    spiq_rx_left = ctx->rx_count;
+    spiq_duplex = ctx->flag_duplex;
+    if (spiq_duplex)
+	spiq_rx_left = 0;
+
+    if (ctx->cs_odr)
+	*ctx->cs_odr &= ~ctx->cs_mask;
+    spiq_delay(ctx->setup);
+
+    if (!ctx->flag_bidir) {
+	SPI_ICR = ICR_RXIE;
+	spiq_next();
+	return;
+    }
+    if (spiq_tx_left) {
+	SPI_ICR = ICR_TXIE;	/* TXE is already set, so ISR starts TX */
+	return;
+    }
+    spiq_bidir_rx();
+}
+
+/******************************************************************************
+ *
+ *  Write next byte in normal mode, or finish
+ */
+
+static void spiq_next(void)
+{
+    if (spiq_tx_left) {
+	spiq_tx_left--;
+	spiq_rx_flight = spiq_duplex;
+	SPI_DR = *spiq_tx_ptr++;
+	return;
+    }
+    if (spiq_rx_left) {
+	spiq_rx_left--;
+	spiq_rx_flight = 1;
+	SPI_DR = SPIQ_FILL;
+	return;
+    }
+    spiq_end();
+}
+
+/******************************************************************************
+ *
+ *  Start bidirectional receive, or finish
+ */
+
+static void spiq_bidir_rx(void)
+{
+    if (!spiq_rx_left) {
+	spiq_end();
+	return;
+    }
+    SPI_ICR = ICR_RXIE;
+    SPI_CR2 &= ~CR2_BDOE;	/* clocks start now */
+    if (spiq_rx_left == 1) {
+	spiq_delay(0);
+	SPI_CR1 &= ~CR1_SPE;	/* stop after this byte */
+    }
+}
+
+/******************************************************************************
+ *
+ *  Finish transaction and start next one
+ */
+
+static void spiq_end(void)
+{
+    SPIQ_CTX	*ctx;
+
+    SPI_ICR = 0;
+    while (SPI_SR & SR_BSY);
+
+    ctx = spiq_head;
+    spiq_delay(ctx->hold);
+    if (ctx->cs_odr)
+	*ctx->cs_odr |= ctx->cs_mask;
+    SPI_CR1 = 0;
+
+    spiq_head = ctx->next;
+    ctx->flag_done = 1;
+    if (spiq_head)
+	spiq_begin(spiq_head);
+}
+
+/******************************************************************************
+ *
+ *  Delay for chip select setup/hold
+ *  in: 500ns units (zero waits one SPI clock)
+ */
+
+static void spiq_delay(char count)
+{
+    char	loop;
+
+    if (!count) {
+	loop = spiq_clock;
+	while (loop--);
+	return;
+    }
+    while (count--)
+	delay_500ns();
+}
+
+/******************************************************************************
+ *
+ *  SPI interrupt
+ */
+
+void spiq_isr(void) __interrupt (IRQ_SPI)
+{
+    char	data;
+
+    if (SPI_ICR & ICR_TXIE) {	/* bidirectional TX */
+	if (!(SPI_SR & SR_TXE))
+	    return;
+	if (spiq_tx_left) {
+	    spiq_tx_left--;
+	    SPI_DR = *spiq_tx_ptr++;
+	    return;
+	}
+	SPI_ICR = 0;
+	while (SPI_SR & SR_BSY);	/* last byte leaving */
+	if (spiq_rx_left)
+	    spiq_delay(spiq_head->setup);	/* turnaround time */
+	spiq_bidir_rx();
+	return;
+    }
+    if (!(SPI_SR & SR_RXNE))
+	return;
+    data = SPI_DR;
+
+    if (spiq_head->flag_bidir) {
+	*spiq_rx_ptr++ = data;
+	spiq_rx_left--;
+	if (spiq_rx_left == 1) {
+	    spiq_delay(0);
+	    SPI_CR1 &= ~CR1_SPE;	/* stop after next byte */
+	}
+	if (!spiq_rx_left)
+	    spiq_end();
+	return;
+    }
+    if (spiq_rx_flight)
+	*spiq_rx_ptr++ = data;
+    spiq_next();
+}
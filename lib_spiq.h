@@ -0,0 +1,113 @@
+/*
+ *  File name:  lib_spiq.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Queued, interrupt-driven SPI master library.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Transactions are posted to a queue and run back to back by the SPI
+ *  interrupt. Each context has its own configuration, chip select pin,
+ *  and setup/hold times, so the caller never has to wait, reconfigure,
+ *  or toggle the chip select by hand.
+ *
+ *  This library owns the SPI interrupt. Do not use it in the same
+ *  program as lib_spi.
+ *
+ *  Pins on STM8S103F: clock C5, MOSI C6, MISO C7.
+ *  In bidirectional mode, TX and RX are both on MOSI (C6).
+ *
+ *  In full-duplex mode, the byte clocked in while each TX byte is sent
+ *  goes to rx_buf, so a register read takes the bus time of the TX alone.
+ *  rx_count is not used, and rx_buf must hold tx_count bytes.
+ *  Duplex is ignored in bidirectional mode.
+ */
+
+#ifndef IRQ_SPI
+#define IRQ_SPI		10
+#endif
+
+/* Configuration bits, same layout as SPI_CR1 */
+
+#define SPIQ_MSB_FIRST	0x00
+#define SPIQ_LSB_FIRST	0x80
+
+#define SPIQ_8MHZ	0x00	/* CPU clock / 2 (at 16 mhz) */
+#define SPIQ_4MHZ	0x08
+#define SPIQ_2MHZ	0x10
+#define SPIQ_1MHZ	0x18
+#define SPIQ_500K	0x20
+#define SPIQ_250K	0x28
+#define SPIQ_125K	0x30
+#define SPIQ_62K	0x38	/* CPU clock / 256 */
+#define SPIQ_SPEED	0x38	/* mask for speed */
+
+#define SPIQ_IDLE_0	0x00	/* clock idles low */
+#define SPIQ_IDLE_1	0x02	/* clock idles high */
+#define SPIQ_EDGE_1	0x00	/* data valid on first clock edge */
+#define SPIQ_EDGE_2	0x01	/* data valid on second clock edge */
+
+#define SPIQ_FILL	0xff	/* sent while receiving */
+
+typedef struct spiq_ctx {
+    char	*tx_buf;	/* data to send */
+    char	*rx_buf;	/* data received */
+    char	tx_count;	/* bytes to send */
+    char	rx_count;	/* bytes to receive after sending */
+    char	config;		/* SPIQ_ bits above */
+    char	flag_bidir;	/* RX and TX share MOSI */
+    char	flag_duplex;	/* receive while sending, no RX phase */
+    volatile char *cs_odr;	/* chip select port (0 if none) */
+    char	cs_mask;	/* chip select pin, active low */
+    char	setup;		/* 500ns units, select to first clock,
+				   and bidir TX to RX turnaround */
+    char	hold;		/* 500ns units, last clock to deselect */
+    volatile char flag_done;	/* set when transaction is finished */
+    struct spiq_ctx *next;	/* queue link, used by library */
+} SPIQ_CTX;
+
+/******************************************************************************
+ *
+ *  Initialize SPI and empty queue
+ */
+
+void spiq_init(void);
+
+/******************************************************************************
+ *
+ *  Post transaction to end of queue
+ *  in: context (must stay valid until flag_done is set)
+ *
+ *  Returns at once. The transaction starts when the ones ahead of it
+ *  are finished, and ctx->flag_done is set when it is done.
+ */
+
+void spiq_post(SPIQ_CTX *);
+
+/******************************************************************************
+ *
+ *  Check for pending transactions
+ *  out: zero if queue is empty and bus is idle
+ */
+
+char spiq_busy(void);
+
+/******************************************************************************
+ *
+ *  Wait for all posted transactions to finish
+ */
+
+void spiq_wait(void);
+
+/******************************************************************************
+ *
+ *  SPI interrupt
+ */
+
+void spiq_isr(void) __interrupt (IRQ_SPI);
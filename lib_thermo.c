@@ -0,0 +1,195 @@
+/*
+ *  File name:  lib_thermo.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Thermostat control for the W1209 board.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  thermo_ntc[] in thermo_lut.h has the temperature at every 2^NTC_SHIFT
+ *  ADC counts, from the beta formula 1/T = 1/T25 + ln(R/R25)/B, held to
+ *  -40.0 and 150.0 C at the ends. It is made by host/gen_ntc.c from the
+ *  NTC line of the Makefile. The NTC is falling, so entries go down and
+ *  the difference to the next entry is never negative.
+ *
+ *  The curve gets steep at the hot end, so the step is set on the NTC
+ *  line too. For the W1209 probe, 8 count steps (258 bytes) are within
+ *  0.6 C of the formula from -30 to 140 C; 32 count steps (66 bytes)
+ *  are within 1 C only up to 85 C, and 3 to 16 C past 90 C (the table
+ *  lists the errors for its own probe and step). The float formula
+ *  takes thousands of cycles and pulls in the float library, which is
+ *  more than an 8K part can spare; see BENCH_TEMP in test_w1209.c.
+ *
+ *  The PID integral is kept from 0 to full output (no windup), and the
+ *  derivative is taken from the temperature, not the error, so a new
+ *  setpoint does not kick the output.
+ */
+
+#include <stdint.h>
+
+#include "lib_thermo.h"
+
+#define NTC_TABLE
+#include "thermo_lut.h"
+
+static char thermo_pid(THERMO *, int, int);
+static char thermo_set(THERMO *, char);
+
+/******************************************************************************
+ *
+ *  Probe reading to temperature
+ *  in: ADC value 0-1023
+ *  out: tenths C, or THERMO_FAULT
+ */
+
+int thermo_temp(uint16_t adc)
+{
+    const int	*tp;
+    uint16_t	frac;
+
+    if (adc < THERMO_ADC_MIN || adc > THERMO_ADC_MAX)
+	return THERMO_FAULT;
+    tp = &thermo_ntc[adc >> NTC_SHIFT];
+    frac = adc & ((1 << NTC_SHIFT) - 1);
+    return tp[0] - (((uint16_t)(tp[0] - tp[1]) * frac) >> NTC_SHIFT);
+}
+
+/******************************************************************************
+ *
+ *  16 bit probe reading to temperature
+ *  in: ADC value scaled to 0-65535
+ *  out: tenths C, or THERMO_FAULT
+ */
+
+int thermo_temp16(uint16_t adc)
+{
+    const int	*tp;
+    uint16_t	frac;
+
+    if ((adc >> 6) < THERMO_ADC_MIN || (adc >> 6) > THERMO_ADC_MAX)
+	return THERMO_FAULT;
+    tp = &thermo_ntc[adc >> (NTC_SHIFT + 6)];
+    frac = adc & ((1 << (NTC_SHIFT + 6)) - 1);
+    return tp[0] -
+	(((uint32_t)(uint16_t)(tp[0] - tp[1]) * frac) >> (NTC_SHIFT + 6));
+}
+
+/******************************************************************************
+ *
+ *  Clear control state (relay off)
+ *  in: thermostat, with settings filled in
+ */
+
+void thermo_reset(THERMO *t)
+{
+    t->relay = 0;
+    t->held = 0xffff;		/* free to switch at once */
+    t->phase = 0;
+    t->out = 0;
+    t->last = THERMO_FAULT;
+    t->integ = 0;
+}
+
+/******************************************************************************
+ *
+ *  Run control loop for one tick
+ *  in: thermostat, temperature (tenths C or THERMO_FAULT)
+ *  out: relay state, 0 or 1
+ */
+
+char thermo_tick(THERMO *t, int temp)
+{
+    int		err;
+    char	want;
+
+    if (t->held != 0xffff)
+	t->held++;
+
+    if (temp == THERMO_FAULT) {
+	t->last = THERMO_FAULT;
+	t->integ = 0;
+	t->out = 0;
+	if (t->relay) {
+	    t->relay = 0;	/* fault is off now, no minimum */
+	    t->held = 0;
+	}
+	return 0;
+    }
+
+    err = t->setpoint - temp;	/* positive when relay is needed */
+    if (t->mode & THERMO_COOL)
+	err = -err;
+
+    if (t->mode & THERMO_PID)
+	want = thermo_pid(t, err, temp);
+    else if (err > t->hyst)
+	want = 1;
+    else if (err <= 0)
+	want = 0;
+    else
+	want = t->relay;
+
+    return thermo_set(t, want);
+}
+
+/******************************************************************************
+ *
+ *  PID step and time proportioning
+ *  in: thermostat, error, temperature
+ *  out: wanted relay state
+ */
+
+static char thermo_pid(THERMO *t, int err, int temp)
+{
+    int32_t	sum;
+    int		derr;
+
+    derr = 0;			/* change of error since last tick */
+    if (t->last != THERMO_FAULT)
+	derr = temp - t->last;
+    if (!(t->mode & THERMO_COOL))
+	derr = -derr;
+    t->last = temp;
+
+    t->integ += (int32_t)t->ki * err;
+    if (t->integ < 0)
+	t->integ = 0;
+    if (t->integ > (int32_t)THERMO_OUT_MAX << 8)
+	t->integ = (int32_t)THERMO_OUT_MAX << 8;
+
+    sum = (int32_t)t->kp * err + t->integ + (int32_t)t->kd * derr;
+    if (sum < 0)
+	t->out = 0;
+    else if (sum >= (int32_t)THERMO_OUT_MAX << 8)
+	t->out = THERMO_OUT_MAX;
+    else
+	t->out = sum >> 8;
+
+    if (++t->phase >= t->window)
+	t->phase = 0;
+    return t->phase < (((uint32_t)t->out * t->window) >> 8);
+}
+
+/******************************************************************************
+ *
+ *  Change relay if it has been on or off long enough
+ *  in: thermostat, wanted state
+ *  out: relay state
+ */
+
+static char thermo_set(THERMO *t, char want)
+{
+    if (want == t->relay)
+	return want;
+    if (t->held < (t->relay ? t->min_on : t->min_off))
+	return t->relay;
+    t->relay = want;
+    t->held = 0;
+    return want;
+}
@@ -0,0 +1,104 @@
+/*
+ *  File name:  lib_thermo.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Thermostat control for the W1209 board.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  thermo_temp() turns a probe reading (w12_probe) into tenths of a
+ *  degree C, from a table in flash with straight lines between entries.
+ *  The table is generated for the NTC in the Makefile, which is the
+ *  W1209 probe: 10K NTC (B 3435) to ground, 20K to the ADC reference,
+ *  10 bit ADC.
+ *
+ *  thermo_temp16() takes the reading scaled to 16 bits, so an
+ *  oversampled reading (lib_decim) keeps its extra bits: shift it left
+ *  by 6 - (extra bits).
+ *
+ *  thermo_tick() runs the control loop, once for each fixed tick (1/10
+ *  second from lib_clock is a good choice), and gives the relay state:
+ *
+ *  THERMO_HYST: on below (setpoint - hyst), off at setpoint, for heat.
+ *	For cool, on above (setpoint + hyst), off at setpoint.
+ *
+ *  THERMO_PID: PID output 0-THERMO_OUT_MAX sets the relay on time in
+ *	each window of "window" ticks (time proportioning).
+ *
+ *  In both modes the relay stays on for at least min_on ticks, and off
+ *  for at least min_off ticks, to save the relay and the compressor.
+ *  A probe fault (open or shorted) turns the relay off.
+ *
+ *  All integer math. The PID step uses 32 bit products, once per tick.
+ */
+
+#define THERMO_FAULT	0x7fff	/* temperature for probe fault */
+#define THERMO_ADC_MIN	8	/* below: shorted probe */
+#define THERMO_ADC_MAX	1015	/* above: open probe */
+
+#define THERMO_HEAT	0x00	/* relay runs a heater */
+#define THERMO_COOL	0x01	/* relay runs a cooler */
+#define THERMO_HYST	0x00	/* on/off with hysteresis */
+#define THERMO_PID	0x02	/* PID with time proportioning */
+
+#define THERMO_OUT_MAX	256	/* PID output for always on */
+
+typedef struct {
+    char	mode;		/* THERMO_HEAT/COOL | THERMO_HYST/PID */
+    int		setpoint;	/* tenths C */
+    int		hyst;		/* tenths C */
+    int		kp;		/* gains, output/256 per tenth C */
+    int		ki;		/* (per tick for ki, */
+    int		kd;		/*  tenth C per tick for kd) */
+    uint16_t	window;		/* PID window, ticks */
+    uint16_t	min_on;		/* ticks */
+    uint16_t	min_off;	/* ticks */
+/* state, cleared by thermo_reset() */
+    char	relay;		/* relay is on */
+    uint16_t	held;		/* ticks since relay changed */
+    uint16_t	phase;		/* ticks into PID window */
+    int		out;		/* last PID output */
+    int		last;		/* last temperature */
+    int32_t	integ;		/* integral, output * 256 */
+} THERMO;
+
+/******************************************************************************
+ *
+ *  Probe reading to temperature
+ *  in: ADC value 0-1023
+ *  out: tenths C, or THERMO_FAULT
+ */
+
+int thermo_temp(uint16_t);
+
+/******************************************************************************
+ *
+ *  16 bit probe reading to temperature
+ *  in: ADC value scaled to 0-65535
+ *  out: tenths C, or THERMO_FAULT
+ */
+
+int thermo_temp16(uint16_t);
+
+/******************************************************************************
+ *
+ *  Clear control state (relay off)
+ *  in: thermostat, with settings filled in
+ */
+
+void thermo_reset(THERMO *);
+
+/******************************************************************************
+ *
+ *  Run control loop for one tick
+ *  in: thermostat, temperature (tenths C or THERMO_FAULT)
+ *  out: relay state, 0 or 1
+ */
+
+char thermo_tick(THERMO *, int);
@@ -0,0 +1,513 @@
+/*
+ *  File name:  lib_tm1638fb.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: TM1638 module with shadow display RAM, bit-banged.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  The TM1638 takes bytes LSB first, latched on the rising edge of CLK,
+ *  with STB low around each command. Data command 0x40 writes with
+ *  auto-increment, 0x44 writes one fixed address, 0x42 reads the keys.
+ *  An address command (0xc0 + address) is followed by the data.
+ *
+ *  Cost of a change list, in bytes:
+ *	fixed:	1 + 2 * changes	(0x44, then address and data for each)
+ *	burst:	2 + span	(0x40, address, data first to last)
+ *  The data command is left out when the chip is already in that mode.
+ *
+ *  The main program only writes tmfb_digit[] and tmfb_leds, and sets
+ *  tmfb_change. The poll clears tmfb_change before it reads them, so a
+ *  write during the poll is picked up by the next one.
+ *
+ *  Keys have one event path: every poll hands the debounced keys to
+ *  keyq_poll(), and tmfb_getc() takes presses and releases from the
+ *  lib_keyq ring.
+ */
+
+#include <stdint.h>
+
+#include "stm8s_header.h"
+
+#include "lib_keyq.h"
+#include "lib_tm1638fb.h"
+
+/* TM1638 commands */
+
+#define CMD_WRITE	0x40	/* auto-increment */
+#define CMD_FIXED	0x44	/* one address */
+#define CMD_READ	0x42	/* key scan */
+#define CMD_ADDR	0xc0
+#define CMD_ON		0x88	/* display on, + brightness 0-7 */
+#define CMD_OFF		0x80
+
+#define RAM_SIZE	16
+
+#define SEG_DP		0x80
+
+static char	tmfb_type;
+static char	tmfb_digit[8];		/* segments, leftmost first */
+static char	tmfb_leds;		/* bit per LED */
+static volatile char tmfb_change;	/* digits or LEDs written */
+static char	tmfb_cursor;
+
+static char	tmfb_image[RAM_SIZE];	/* wanted chip RAM */
+static char	tmfb_chip[RAM_SIZE];	/* chip RAM as sent */
+static char	tmfb_mode;		/* last data command sent */
+
+static char	tmfb_ctrl;		/* display control wanted */
+static char	tmfb_ctrl_chip;		/* display control as sent */
+static char	tmfb_brate;		/* blink 1/100s, 0 for none */
+static uint16_t	tmfb_bwait;		/* polls to blink change */
+static char	tmfb_boff;		/* blinked off */
+
+static char	tmfb_scan;		/* polls to key scan */
+static uint16_t	tmfb_last;		/* keys at last scan */
+static volatile uint16_t tmfb_down;	/* keys down, debounced */
+static const char *tmfb_map;
+
+/* Segments for ' ' to '_' (lower case shows as upper) */
+
+static const char tmfb_font[64] = {
+    0x00, 0x86, 0x22, 0x00, 0x6d, 0x00, 0x00, 0x20,	/*  !"#$%&' */
+    0x39, 0x0f, 0x00, 0x00, 0x00, 0x40, 0x80, 0x52,	/* ()*+,-./ */
+    0x3f, 0x06, 0x5b, 0x4f, 0x66, 0x6d, 0x7d, 0x07,	/* 01234567 */
+    0x7f, 0x6f, 0x00, 0x00, 0x00, 0x48, 0x00, 0x53,	/* 89:;<=>? */
+    0x5f, 0x77, 0x7c, 0x39, 0x5e, 0x79, 0x71, 0x3d,	/* @ABCDEFG */
+    0x76, 0x06, 0x1e, 0x75, 0x38, 0x37, 0x54, 0x3f,	/* HIJKLMNO */
+    0x73, 0x67, 0x50, 0x6d, 0x78, 0x3e, 0x1c, 0x2a,	/* PQRSTUVW */
+    0x76, 0x6e, 0x5b, 0x39, 0x64, 0x0f, 0x23, 0x08	/* XYZ[\]^_ */
+};
+
+static const char tmfb_map8[] = "01234567";
+static const char tmfb_map16[] = "0123456789ABCDEF";
+
+static void tmfb_build(void);
+static void tmfb_push(void);
+static void tmfb_keyscan(void);
+static void tmfb_command(char);
+static void tmfb_byte(char);
+static char tmfb_read(void);
+
+/******************************************************************************
+ *
+ *  Initialize pins and module, clear display
+ *  in: TMFB_8 or TMFB_16
+ */
+
+void tmfb_init(char type)
+{
+    char	i;
+
+    tmfb_type = type;
+    tmfb_map = (type == TMFB_16) ? tmfb_map16 : tmfb_map8;
+
+    TMFB_ODR |= TMFB_STB | TMFB_CLK | TMFB_DIO;	/* all idle high */
+    TMFB_DDR |= TMFB_STB | TMFB_CLK | TMFB_DIO;
+    TMFB_CR1 |= TMFB_STB | TMFB_CLK | TMFB_DIO;	/* push-pull */
+
+    for (i = 0; i < 8; i++)
+	tmfb_digit[i] = 0;
+    tmfb_leds = 0;
+    tmfb_change = 0;
+    tmfb_cursor = 0;
+
+    tmfb_command(CMD_WRITE);
+    tmfb_mode = CMD_WRITE;
+    TMFB_ODR &= ~TMFB_STB;
+    tmfb_byte(CMD_ADDR);
+    for (i = 0; i < RAM_SIZE; i++) {
+	tmfb_byte(0);
+	tmfb_image[i] = 0;
+	tmfb_chip[i] = 0;
+    }
+    TMFB_ODR |= TMFB_STB;
+
+    tmfb_ctrl = CMD_ON | 4;
+    tmfb_ctrl_chip = tmfb_ctrl;
+    tmfb_command(tmfb_ctrl);
+    tmfb_brate = 0;
+    tmfb_boff = 0;
+
+    tmfb_scan = TMFB_SCAN;
+    tmfb_last = 0;
+    tmfb_down = 0;
+    keyq_init(tmfb_map, 0, 0);		/* no long press or repeat */
+}
+
+/******************************************************************************
+ *
+ *  Set brightness
+ *  in: level 0-7
+ */
+
+void tmfb_bright(char level)
+{
+    tmfb_ctrl = CMD_ON | (level & 7);
+}
+
+/******************************************************************************
+ *
+ *  Blink whole display
+ *  in: 1/100 seconds on and off, for 1 ms polls (0 for no blink)
+ */
+
+void tmfb_blink(char rate)
+{
+    tmfb_brate = 0;
+    tmfb_boff = 0;
+    tmfb_bwait = (uint16_t)rate * 10;
+    tmfb_brate = rate;
+}
+
+/******************************************************************************
+ *
+ *  Set cursor
+ *  in: digit 0-7 from the left
+ */
+
+void tmfb_curs(char pos)
+{
+    tmfb_cursor = pos & 7;
+}
+
+/******************************************************************************
+ *
+ *  Put character at cursor
+ *  in: character ('.' sets the point of the digit before the cursor)
+ */
+
+void tmfb_putc(char c)
+{
+    if (c == '.') {
+	if (tmfb_cursor)
+	    tmfb_digit[tmfb_cursor - 1] |= SEG_DP;
+	tmfb_change = 1;
+	return;
+    }
+    if (tmfb_cursor > 7)
+	return;
+    if (c >= 'a' && c <= 'z')
+	c -= 'a' - 'A';
+    if (c < ' ' || c > '_')
+	c = ' ';
+    tmfb_digit[tmfb_cursor++] = tmfb_font[c - ' '];
+    tmfb_change = 1;
+}
+
+/******************************************************************************
+ *
+ *  Put string at cursor, stops at the last digit
+ *  in: string
+ */
+
+void tmfb_puts(const char *str)
+{
+    while (*str)
+	tmfb_putc(*str++);
+}
+
+/******************************************************************************
+ *
+ *  Set segments of one digit
+ *  in: digit 0-7, segments (bit 0 is a, bit 7 is the point)
+ */
+
+void tmfb_set(char digit, char segs)
+{
+    tmfb_digit[digit & 7] = segs;
+    tmfb_change = 1;
+}
+
+/******************************************************************************
+ *
+ *  Set LED (TMFB_8)
+ *  in: LED 0-7, 0 for off
+ */
+
+void tmfb_setled(char led, char on)
+{
+    if (on)
+	tmfb_leds |= 1 << (led & 7);
+    else
+	tmfb_leds &= ~(1 << (led & 7));
+    tmfb_change = 1;
+}
+
+/******************************************************************************
+ *
+ *  Load key map
+ *  in: one character for each key, in key number order
+ */
+
+void tmfb_kmap(const char *map)
+{
+    tmfb_map = map;
+    keyq_kmap(map);
+}
+
+/******************************************************************************
+ *
+ *  Get key map
+ *  out: map from tmfb_kmap(), or the one tmfb_init() chose
+ */
+
+const char *tmfb_kmap_get(void)
+{
+    return tmfb_map;
+}
+
+/******************************************************************************
+ *
+ *  Get key event
+ *  out: key from map (bit 7 set for release), or 0 for none
+ */
+
+char tmfb_getc(void)
+{
+    KEYQ_EVENT	ev;
+
+    while (keyq_get(&ev)) {		/* skip chord, long and repeat */
+	if (ev.type == KEYQ_PRESS)
+	    return ev.code;
+	if (ev.type == KEYQ_RELEASE)
+	    return ev.code | 0x80;
+    }
+    return 0;
+}
+
+/******************************************************************************
+ *
+ *  Get keys now down
+ *  out: one bit per key number
+ */
+
+uint16_t tmfb_keys(void)
+{
+    uint16_t	keys;
+
+    do {
+	keys = tmfb_down;
+    } while (keys != tmfb_down);
+    return keys;
+}
+
+/******************************************************************************
+ *
+ *  Send display changes or scan keys, call from millisecond timer
+ *  (also calls keyq_poll)
+ */
+
+void tmfb_poll(void)
+{
+    char	ctrl;
+
+    keyq_poll(tmfb_down);		/* keys from last scan, 1 msec */
+
+    if (tmfb_brate && !--tmfb_bwait) {	/* count scan polls too */
+	tmfb_bwait = (uint16_t)tmfb_brate * 10;
+	tmfb_boff ^= 1;
+    }
+
+    if (!--tmfb_scan) {
+	tmfb_scan = TMFB_SCAN;
+	tmfb_keyscan();
+	return;
+    }
+
+    ctrl = tmfb_ctrl;
+    if (tmfb_brate && tmfb_boff)
+	ctrl = CMD_OFF;
+    if (ctrl != tmfb_ctrl_chip) {
+	tmfb_command(ctrl);
+	tmfb_ctrl_chip = ctrl;
+    }
+
+    if (tmfb_change) {
+	tmfb_change = 0;
+	tmfb_build();
+    }
+    tmfb_push();
+}
+
+/******************************************************************************
+ *
+ *  Build chip RAM image from digits and LEDs
+ */
+
+static void tmfb_build(void)
+{
+    char	i, d, bits, segs;
+
+    if (tmfb_type != TMFB_16) {
+	for (i = 0; i < 8; i++) {
+	    tmfb_image[i * 2] = tmfb_digit[i];
+	    tmfb_image[i * 2 + 1] = (tmfb_leds >> i) & 1;
+	}
+	return;
+    }
+    for (i = 0; i < 8; i++)		/* segment i of each digit */
+	tmfb_image[i * 2] = 0;
+    for (d = 0; d < 8; d++) {
+	segs = tmfb_digit[d];
+	bits = 1 << d;
+	for (i = 0; i < 8; i++) {
+	    if (segs & 1)
+		tmfb_image[i * 2] |= bits;
+	    segs >>= 1;
+	}
+    }
+}
+
+/******************************************************************************
+ *
+ *  Send changed addresses, one at a time or as a burst
+ */
+
+static void tmfb_push(void)
+{
+    char	addr, first, last, count;
+
+    count = 0;
+    first = 0;
+    last = 0;
+    for (addr = 0; addr < RAM_SIZE; addr++) {
+	if (tmfb_image[addr] == tmfb_chip[addr])
+	    continue;
+	if (!count)
+	    first = addr;
+	last = addr;
+	count++;
+    }
+    if (!count)
+	return;
+
+    if (last - first + 2 <= count * 2) {	/* burst is no more bytes */
+	if (tmfb_mode != CMD_WRITE)
+	    tmfb_command(CMD_WRITE);
+	tmfb_mode = CMD_WRITE;
+	TMFB_ODR &= ~TMFB_STB;
+	tmfb_byte(CMD_ADDR + first);
+	for (addr = first; addr <= last; addr++) {
+	    tmfb_chip[addr] = tmfb_image[addr];
+	    tmfb_byte(tmfb_chip[addr]);
+	}
+	TMFB_ODR |= TMFB_STB;
+	return;
+    }
+
+    if (tmfb_mode != CMD_FIXED)
+	tmfb_command(CMD_FIXED);
+    tmfb_mode = CMD_FIXED;
+    for (addr = first; addr <= last; addr++) {
+	if (tmfb_image[addr] == tmfb_chip[addr])
+	    continue;
+	tmfb_chip[addr] = tmfb_image[addr];
+	TMFB_ODR &= ~TMFB_STB;
+	tmfb_byte(CMD_ADDR + addr);
+	tmfb_byte(tmfb_chip[addr]);
+	TMFB_ODR |= TMFB_STB;
+    }
+}
+
+/******************************************************************************
+ *
+ *  Read keys, keep them when they read the same twice
+ */
+
+static void tmfb_keyscan(void)
+{
+    uint16_t	keys;
+    char	i, data;
+
+    TMFB_ODR &= ~TMFB_STB;
+    tmfb_byte(CMD_READ);
+    tmfb_mode = CMD_READ;
+    TMFB_DDR &= ~TMFB_DIO;		/* input with pullup */
+    __asm__("nop\n nop\n nop\n nop\n nop\n nop\n nop\n nop");	/* 1 usec */
+    __asm__("nop\n nop\n nop\n nop\n nop\n nop\n nop\n nop");	/* at 16 mhz */
+
+    keys = 0;
+    for (i = 0; i < 4; i++) {
+	data = tmfb_read();
+	if (tmfb_type == TMFB_16) {
+	    if (data & 0x04) keys |= 1 << i;
+	    if (data & 0x40) keys |= 1 << (i + 4);
+	    if (data & 0x02) keys |= 1 << (i + 8);
+	    if (data & 0x20) keys |= (uint16_t)1 << (i + 12);
+	}
+	else {
+	    if (data & 0x01) keys |= 1 << i;
+	    if (data & 0x10) keys |= 1 << (i + 4);
+	}
+    }
+    TMFB_ODR |= TMFB_STB | TMFB_DIO;
+    TMFB_DDR |= TMFB_DIO;
+
+    if (keys != tmfb_last) {		/* not the same twice */
+	tmfb_last = keys;
+	return;
+    }
+    tmfb_down = keys;
+}
+
+/******************************************************************************
+ *
+ *  Send one byte command with its own strobe
+ *  in: command
+ */
+
+static void tmfb_command(char cmd)
+{
+    TMFB_ODR &= ~TMFB_STB;
+    tmfb_byte(cmd);
+    TMFB_ODR |= TMFB_STB;
+}
+
+/******************************************************************************
+ *
+ *  Send one byte, LSB first
+ *  in: byte
+ */
+
+static void tmfb_byte(char data)
+{
+    char	i;
+
+    for (i = 0; i < 8; i++) {
+	TMFB_ODR &= ~TMFB_CLK;
+	if (data & 1)
+	    TMFB_ODR |= TMFB_DIO;
+	else
+	    TMFB_ODR &= ~TMFB_DIO;
+	data >>= 1;
+	TMFB_ODR |= TMFB_CLK;
+    }
+}
+
+/******************************************************************************
+ *
+ *  Read one byte, LSB first (DIO is input)
+ *  out: byte
+ */
+
+static char tmfb_read(void)
+{
+    char	i, data;
+
+    data = 0;
+    for (i = 0; i < 8; i++) {
+	TMFB_ODR &= ~TMFB_CLK;
+	data >>= 1;
+	TMFB_ODR |= TMFB_CLK;
+	if (TMFB_IDR & TMFB_DIO)
+	    data |= 0x80;
+    }
+    return data;
+}
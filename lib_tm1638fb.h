@@ -0,0 +1,162 @@
+/*
+ *  File name:  lib_tm1638fb.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: TM1638 module with shadow display RAM, bit-banged.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Writes only go to RAM. tmfb_poll(), called from the millisecond
+ *  timer, builds the 16 byte image of the TM1638 display RAM, compares
+ *  it with what the chip already has, and sends only the addresses that
+ *  changed. A few changes are sent one address each (fixed address
+ *  mode); more are sent as one auto-increment burst from the first
+ *  change to the last, whichever is fewer bytes on the bus. A display
+ *  that changes one digit per second costs 3 bytes, not 17, and there
+ *  is no push call for the 16 key module.
+ *
+ *  Every TMFB_SCAN polls the keys are read instead, so a poll never does
+ *  both. A key must read the same twice in a row to count.
+ *
+ *  TMFB_8 is the LED&KEY module: 8 digits, 8 LEDs, 8 keys.
+ *  TMFB_16 is the QYF-TM1638 module: 8 digits, 16 keys, with segments
+ *  and digits swapped in the chip RAM.
+ *
+ *  Key numbers are 0-7 (TMFB_8) or 0-15 (TMFB_16), in the order they
+ *  are read, and go through the key map, which starts as "01234567" or
+ *  "0123456789ABCDEF".
+ *
+ *  Key events are kept by lib_keyq, which must be linked too. Every
+ *  poll passes the keys down to keyq_poll(), and tmfb_init() starts it
+ *  with no long press. tmfb_getc() takes presses and releases from it.
+ *  For event times, chords, long press and repeat, call keyq_init()
+ *  with tmfb_kmap_get() after tmfb_init(), and read with keyq_get().
+ *
+ *  Pins: STB on C3, CLK on C4, DIO on C5, all on one port. Define
+ *  TMFB_ODR and the rest before including this file to move them.
+ */
+
+#ifndef TMFB_ODR
+#define TMFB_ODR	PC_ODR
+#define TMFB_IDR	PC_IDR
+#define TMFB_DDR	PC_DDR
+#define TMFB_CR1	PC_CR1
+#define TMFB_STB	0x08	/* C3 */
+#define TMFB_CLK	0x10	/* C4 */
+#define TMFB_DIO	0x20	/* C5 */
+#endif
+
+#define TMFB_8		8	/* LED&KEY module */
+#define TMFB_16		16	/* QYF-TM1638 module */
+
+#define TMFB_SCAN	10	/* polls per key scan */
+
+/******************************************************************************
+ *
+ *  Initialize pins and module, clear display
+ *  in: TMFB_8 or TMFB_16
+ */
+
+void tmfb_init(char);
+
+/******************************************************************************
+ *
+ *  Set brightness
+ *  in: level 0-7
+ */
+
+void tmfb_bright(char);
+
+/******************************************************************************
+ *
+ *  Blink whole display
+ *  in: 1/100 seconds on and off, for 1 ms polls (0 for no blink)
+ */
+
+void tmfb_blink(char);
+
+/******************************************************************************
+ *
+ *  Set cursor
+ *  in: digit 0-7 from the left
+ */
+
+void tmfb_curs(char);
+
+/******************************************************************************
+ *
+ *  Put character at cursor
+ *  in: character ('.' sets the point of the digit before the cursor)
+ */
+
+void tmfb_putc(char);
+
+/******************************************************************************
+ *
+ *  Put string at cursor, stops at the last digit
+ *  in: string
+ */
+
+void tmfb_puts(const char *);
+
+/******************************************************************************
+ *
+ *  Set segments of one digit
+ *  in: digit 0-7, segments (bit 0 is a, bit 7 is the point)
+ */
+
+void tmfb_set(char, char);
+
+/******************************************************************************
+ *
+ *  Set LED (TMFB_8)
+ *  in: LED 0-7, 0 for off
+ */
+
+void tmfb_setled(char, char);
+
+/******************************************************************************
+ *
+ *  Load key map
+ *  in: one character for each key, in key number order
+ */
+
+void tmfb_kmap(const char *);
+
+/******************************************************************************
+ *
+ *  Get key map
+ *  out: map from tmfb_kmap(), or the one tmfb_init() chose
+ */
+
+const char *tmfb_kmap_get(void);
+
+/******************************************************************************
+ *
+ *  Get key event
+ *  out: key from map (bit 7 set for release), or 0 for none
+ */
+
+char tmfb_getc(void);
+
+/******************************************************************************
+ *
+ *  Get keys now down
+ *  out: one bit per key number
+ */
+
+uint16_t tmfb_keys(void);
+
+/******************************************************************************
+ *
+ *  Send display changes or scan keys, call from millisecond timer
+ *  (also calls keyq_poll)
+ */
+
+void tmfb_poll(void);
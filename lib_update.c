@@ -0,0 +1,205 @@
+/*
+ *  File name:  lib_update.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Receive binary blocks over the UART and program them.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  upd_byte() is a state machine over the frame. The CRC is updated
+ *  with each byte, so a finished frame is checked with one compare.
+ */
+
+#include <stdint.h>
+
+#include "lib_crc.h"
+#include "lib_flashblk.h"
+#include "lib_uart.h"
+#include "lib_update.h"
+
+#define ST_SOH		0	/* waiting for SOH */
+#define ST_ADDR_HI	1
+#define ST_ADDR_LO	2
+#define ST_COUNT	3
+#define ST_DATA		4
+#define ST_CRC_HI	5
+#define ST_CRC_LO	6
+
+typedef struct {
+    uint16_t	addr;
+    char	count;
+    char	data[FLASHBLK_SIZE];
+} UPD_BUF;
+
+static UPD_BUF	upd_rx;			/* frame being received */
+static char	upd_state;
+static uint8_t	upd_pos;		/* data bytes received */
+static uint16_t	upd_crc;		/* running CRC */
+static uint16_t	upd_crc_rx;		/* CRC from frame */
+static volatile char upd_idle;		/* msecs since last byte */
+
+static uint16_t	upd_base;		/* area that may be programmed */
+static uint16_t	upd_last;		/* last address in area */
+static UPD_STAT	upd_stats;
+
+static char upd_byte(char);
+static char upd_program(UPD_BUF *);
+
+/******************************************************************************
+ *
+ *  Set area that may be programmed, clear statistics
+ *  in: start (block aligned), size
+ */
+
+void upd_init(char *base, int size)
+{
+    upd_base = (uint16_t)base;
+    upd_last = upd_base + (size - 1);	/* base + size may wrap to 0 */
+    upd_state = ST_SOH;
+    upd_stats.blocks = 0;
+    upd_stats.errors = 0;
+}
+
+/******************************************************************************
+ *
+ *  Take bytes from the UART, program finished frames
+ *  out: UPD_IDLE, UPD_BLOCK, UPD_ERROR, or UPD_DONE
+ */
+
+char upd_poll(void)
+{
+    char	retval;
+
+    if (upd_state != ST_SOH && upd_idle > UPD_TIMEOUT)
+	upd_state = ST_SOH;	/* sender gave up on this frame */
+
+    while (uart_rsize()) {
+	upd_idle = 0;
+	if (!upd_byte(uart_get()))
+	    continue;
+
+	if (upd_crc != upd_crc_rx)
+	    retval = UPD_ERROR;
+	else if (!upd_rx.count)
+	    retval = UPD_DONE;
+	else
+	    retval = upd_program(&upd_rx);
+
+	if (retval == UPD_ERROR) {
+	    upd_stats.errors++;
+	    uart_put(UPD_NAK);
+	}
+	else
+	    uart_put(UPD_ACK);
+	return retval;
+    }
+    return UPD_IDLE;
+}
+
+/******************************************************************************
+ *
+ *  Millisecond tick, for frame timeout
+ */
+
+void upd_tick(void)
+{
+    if (upd_idle < 255)
+	upd_idle++;
+}
+
+/******************************************************************************
+ *
+ *  Get statistics
+ *  in: statistics
+ */
+
+void upd_stat(UPD_STAT *stat)
+{
+    stat->blocks = upd_stats.blocks;
+    stat->errors = upd_stats.errors;
+}
+
+/******************************************************************************
+ *
+ *  Add byte to frame
+ *  in: byte
+ *  out: non-zero when frame is complete
+ */
+
+static char upd_byte(char c)
+{
+    if (upd_state == ST_SOH) {
+	if (c == UPD_SOH) {
+	    upd_crc = CRC16_INIT;
+	    upd_state = ST_ADDR_HI;
+	}
+	return 0;
+    }
+    if (upd_state == ST_CRC_HI) {
+	upd_crc_rx = (uint16_t)c << 8;
+	upd_state = ST_CRC_LO;
+	return 0;
+    }
+    if (upd_state == ST_CRC_LO) {
+	upd_crc_rx |= c;
+	upd_state = ST_SOH;
+	return 1;
+    }
+
+    upd_crc = crc16_update(upd_crc, &c, 1);
+    switch (upd_state) {
+    case ST_ADDR_HI:
+	upd_rx.addr = (uint16_t)c << 8;
+	upd_state = ST_ADDR_LO;
+	break;
+    case ST_ADDR_LO:
+	upd_rx.addr |= c;
+	upd_state = ST_COUNT;
+	break;
+    case ST_COUNT:
+	upd_rx.count = c;
+	upd_pos = 0;
+	upd_state = c ? ST_DATA : ST_CRC_HI;
+	if (c > FLASHBLK_SIZE)
+	    upd_state = ST_SOH;		/* not a frame */
+	break;
+    case ST_DATA:
+	upd_rx.data[upd_pos++] = c;
+	if (upd_pos == upd_rx.count)
+	    upd_state = ST_CRC_HI;
+	break;
+    }
+    return 0;
+}
+
+/******************************************************************************
+ *
+ *  Program and verify one block
+ *  in: buffer
+ *  out: UPD_BLOCK or UPD_ERROR
+ */
+
+static char upd_program(UPD_BUF *buf)
+{
+    char	*ptr;
+    uint8_t	i;
+
+    if (buf->count != FLASHBLK_SIZE || buf->addr < upd_base ||
+	buf->addr > upd_last)
+	return UPD_ERROR;
+
+    ptr = (char *)buf->addr;
+    if (flashblk_write(ptr, buf->data, FLASHBLK_STANDARD))
+	return UPD_ERROR;
+    for (i = 0; i < FLASHBLK_SIZE; i++)
+	if (ptr[i] != buf->data[i])
+	    return UPD_ERROR;
+    upd_stats.blocks++;
+    return UPD_BLOCK;
+}
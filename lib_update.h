@@ -0,0 +1,82 @@
+/*
+ *  File name:  lib_update.h
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Receive binary blocks over the UART and program them.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Frame:  SOH, address high, address low, count, data, CRC high, low
+ *
+ *  The count is FLASHBLK_SIZE, or zero for the end frame. The CRC is
+ *  CRC-16/CCITT (lib_crc) of the address, count and data. Each frame is
+ *  answered with ACK (0x06) after it is programmed and verified, or NAK
+ *  (0x15) if it was damaged, out of range, or failed to program. The
+ *  sender resends on NAK, or if there is no answer.
+ *
+ *  The CRC is done as the bytes arrive, so a finished frame is checked
+ *  with one compare.
+ *
+ *  This is stop-and-wait, with one frame buffer, not double buffered.
+ *  The STM8S103 cannot read its flash during a block write, so the CPU
+ *  stops with interrupts off for it (erase and program, about 6 msec),
+ *  and UART bytes arriving then would be lost. No next frame can be
+ *  received while a block is programmed, so the sender must wait for
+ *  each ACK, and a second buffer would never be filled.
+ *
+ *  Uses lib_uart, lib_crc, and lib_flashblk (call flashblk_init first).
+ *  Host sender: host/send_update.c
+ */
+
+#define UPD_SOH		0x01
+#define UPD_ACK		0x06
+#define UPD_NAK		0x15
+
+#define UPD_TIMEOUT	50	/* msec, partial frame is dropped */
+
+#define UPD_IDLE	0	/* nothing finished */
+#define UPD_BLOCK	1	/* block programmed */
+#define UPD_ERROR	2	/* frame rejected */
+#define UPD_DONE	3	/* end frame received */
+
+typedef struct {
+    uint16_t	blocks;		/* blocks programmed */
+    uint16_t	errors;		/* frames rejected */
+} UPD_STAT;
+
+/******************************************************************************
+ *
+ *  Set area that may be programmed, clear statistics
+ *  in: start (block aligned), size
+ */
+
+void upd_init(char *, int);
+
+/******************************************************************************
+ *
+ *  Take bytes from the UART, program finished frames
+ *  out: UPD_IDLE, UPD_BLOCK, UPD_ERROR, or UPD_DONE
+ */
+
+char upd_poll(void);
+
+/******************************************************************************
+ *
+ *  Millisecond tick, for frame timeout (call from clock callback)
+ */
+
+void upd_tick(void);
+
+/******************************************************************************
+ *
+ *  Get statistics
+ *  in: statistics
+ */
+
+void upd_stat(UPD_STAT *);
@@ -1,7 +1,7 @@
 /*
  *  File name:  test_bindec.c
  *  Date first: 06/10/2018
- *  Date last:  09/14/2022
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for bindec library.
  *
@@ -22,18 +22,32 @@
  *
  * 1: bin16_dec (full test)
  *    dec_bin16 (tested against each other)
+ *    bin16_dec_fast (must match bin16_dec)
  * 2: bin8_dec2 (full test)
+ *    bin8_dec2_fast (must match bin8_dec2)
  * 3: bin8_hex  (full test)
+ *    bin8_hex_fast (must match bin8_hex)
  * 4: bin32_dec (test low 16 bits)
+ *    bin32_dec_fast (must match bin32_dec)
  * 5: bin32_dec (test with prime pattern, verify low 16 bits)
+ *    bin32_dec_fast (must match bin32_dec)
+ *
+ * The cycle count of each test is printed to the UART as "PHASE n".
+ * With TEST_BENCH, the tests are replaced by timing each conversion
+ * over the same value sweeps, printing min/avg/max cycles per call.
+ * Build with -DSIM ("make sim") to run under the ucsim simulator,
+ * which stops at the end or at the first failure.
  */
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
 #include "lib_board.h"
 #include "lib_clock.h"
+#include "lib_fastdec.h"
 #include "lib_tm1638.h"
+#include "lib_uart.h"
 
 void timer_ms(void);	/* millisecond timer call */
 void timer_10(void);	/* 1/10 second timer call */
@@ -49,12 +63,16 @@ void test_3(void);	/* Test bin8_hex. */
 void test_4(void);	/* Test bin32_dec, low 16 bits. */
 void test_5(int);	/* Test bin32_dec, prime pattern, verify low 16 bits */
 
+void test_bench(void);	/* Time each conversion. */
+
 void test_number(char);	/* Display test number. */
 void test_fail(void);	/* Flash display and stop. */
 
 char hex_bin8(char *);	/* 2 char hex to binary */
+void test_same(char *, char *); /* Fail if strings differ. */
 
 //#define FORCE_FAIL	/* Force failure for testing. */
+//#define TEST_BENCH	/* Time conversions instead of testing them. */
 
 #define PRIME_PATTERN 13
 
@@ -72,6 +90,8 @@ static char module_type;
  */
 
 int main() {
+    uint32_t	start;
+
     module_type = TM1638_8;	/* choose TM1638_8 or TM1638_16 */
 
     board_init(0);
@@ -79,20 +99,41 @@ int main() {
     tm1638_init(module_type);
     tm1638_bright(4);
     clock_init(timer_ms, timer_10);
+    uart_init(BAUD_115200);
+    bench_init();
 
+    uart_puts("test_bindec\r\n");
+#ifdef TEST_BENCH
+    test_bench();
+    bench_stop();
+#endif
+    start = bench_read32();
     test_1();	/* Test bin16_dec and dec_bin16. */
+    bench_phase(1, bench_read32() - start);
+
+    start = bench_read32();
     test_2();	/* Test bin8_dec2. */
+    bench_phase(2, bench_read32() - start);
+
+    start = bench_read32();
     test_3();	/* Test bin8_hex. */
+    bench_phase(3, bench_read32() - start);
 #ifdef FORCE_FAIL
     test_fail();
 #endif
+    start = bench_read32();
     test_4();	/* Test bin32_dec, low 16 bits. */
+    bench_phase(4, bench_read32() - start);
+
+    start = bench_read32();
     test_5(PRIME_PATTERN); /* Test bin32_dec with pattern, verify low 16 bits */
+    bench_phase(5, bench_read32() - start);
 
     disp_clear();
     disp_curs(4);
     disp_puts("PASS");
-    for (;;);
+    uart_puts("PASS\r\n");
+    bench_stop();
 }
 
 /******************************************************************************
@@ -104,6 +145,7 @@ void test_1(void)
 {
     int		count, retval;
     char	decimal[6];
+    char	fast[6];
     
     test_number(1);
 
@@ -115,6 +157,8 @@ void test_1(void)
 	retval = dec_bin16(decimal);
 	if (retval != count)
 	    test_fail();
+	bin16_dec_fast(count, fast);
+	test_same(decimal, fast);
 	count++;
 	if (count == 0)
 	    break;
@@ -130,6 +174,7 @@ void test_2(void)
 {
     int		count, retval;
     char	decimal[3];
+    char	fast[3];
 
     test_number(2);
 
@@ -145,6 +190,8 @@ void test_2(void)
 	    disp_puts(decimal);
 	    test_fail();
 	}
+	bin8_dec2_fast(count, fast);
+	test_same(decimal, fast);
 	count++;
 	if (count == 100)
 	    break;
@@ -160,6 +207,7 @@ void test_3(void)
 {
     int		count, retval;
     char	hex[3];
+    char	fast[3];
 
     test_number(3);
 
@@ -175,6 +223,8 @@ void test_3(void)
 	    disp_puts(hex);
 	    test_fail();
 	}
+	bin8_hex_fast(count, fast);
+	test_same(hex, fast);
 	count++;
 	if (count == 256)
 	    break;
@@ -191,6 +241,7 @@ void test_4(void)
     unsigned long count;
     unsigned int retval;
     char	decimal[11];
+    char	fast[11];
     
     test_number(4);
 
@@ -202,6 +253,8 @@ void test_4(void)
 	retval = dec_bin16(decimal);
 	if (retval != count)
 	    test_fail();
+	bin32_dec_fast(count, fast);
+	test_same(decimal, fast);
 	count++;
 	if (count == 0x10000)
 	    break;
@@ -219,6 +272,7 @@ void test_5(int pattern)
     unsigned long count;
     unsigned int retval;
     char	decimal[11];
+    char	fast[11];
     
     test_number(5);
 
@@ -230,12 +284,101 @@ void test_5(int pattern)
 	retval = dec_bin16(decimal);
 	if (retval != (count & 0xffff))
 	    test_fail();
+	bin32_dec_fast(count, fast);
+	test_same(decimal, fast);
 	count += pattern;
 	if (count > 0x100000)
 	    break;
     }
 }
 
+/******************************************************************************
+ *
+ *  Time each conversion over the same sweeps as the tests.
+ *  Interrupts are off during each timed call so that the display
+ *  and clock callbacks do not count against the conversion.
+ */
+
+#define BENCH_CALL(call) {					\
+	__asm__ ("sim");					\
+	t = bench_read();					\
+	call;							\
+	t = bench_read() - t;					\
+	__asm__ ("rim");					\
+	bench_add(&stat, t);					\
+    }
+
+void test_bench(void)
+{
+    BENCH_STAT	stat;
+    unsigned long count32;
+    uint16_t	t;
+    int		count;
+    char	decimal[11];
+
+    bench_clear(&stat);
+    count = 0;
+    do {
+	BENCH_CALL(bin16_dec(count, decimal));
+    } while (++count);
+    bench_print("bin16_dec", &stat);
+
+    bench_clear(&stat);
+    count = 0;
+    do {
+	BENCH_CALL(bin16_dec_fast(count, decimal));
+    } while (++count);
+    bench_print("bin16_dec_fast", &stat);
+
+    bench_clear(&stat);
+    count = 0;
+    do {
+	bin16_dec(count, decimal);
+	BENCH_CALL(dec_bin16(decimal));
+    } while (++count);
+    bench_print("dec_bin16", &stat);
+
+    bench_clear(&stat);
+    for (count = 0; count < 100; count++)
+	BENCH_CALL(bin8_dec2(count, decimal));
+    bench_print("bin8_dec2", &stat);
+
+    bench_clear(&stat);
+    for (count = 0; count < 100; count++)
+	BENCH_CALL(bin8_dec2_fast(count, decimal));
+    bench_print("bin8_dec2_fast", &stat);
+
+    bench_clear(&stat);
+    for (count = 0; count < 256; count++)
+	BENCH_CALL(bin8_hex(count, decimal));
+    bench_print("bin8_hex", &stat);
+
+    bench_clear(&stat);
+    for (count = 0; count < 256; count++)
+	BENCH_CALL(bin8_hex_fast(count, decimal));
+    bench_print("bin8_hex_fast", &stat);
+
+    bench_clear(&stat);
+    for (count32 = 0; count32 < 0x10000; count32++)
+	BENCH_CALL(bin32_dec(count32, decimal));
+    bench_print("bin32_dec (low)", &stat);
+
+    bench_clear(&stat);
+    for (count32 = 0; count32 < 0x10000; count32++)
+	BENCH_CALL(bin32_dec_fast(count32, decimal));
+    bench_print("bin32_dec_fast (low)", &stat);
+
+    bench_clear(&stat);
+    for (count32 = 0; count32 <= 0x100000; count32 += PRIME_PATTERN)
+	BENCH_CALL(bin32_dec(count32, decimal));
+    bench_print("bin32_dec (pattern)", &stat);
+
+    bench_clear(&stat);
+    for (count32 = 0; count32 <= 0x100000; count32 += PRIME_PATTERN)
+	BENCH_CALL(bin32_dec_fast(count32, decimal));
+    bench_print("bin32_dec_fast (pattern)", &stat);
+}
+
 /******************************************************************************
  *
  *  Clear display and show test number.
@@ -257,7 +400,23 @@ void test_number(char tnum)
 void test_fail(void)
 {
     disp_blink(25);	/* Rate is 25/100 second. */
-    for (;;);
+    uart_puts("FAIL\r\n");
+    bench_stop();
+}
+
+/******************************************************************************
+ *
+ *  Compare two conversion results, fail if different.
+ */
+
+void test_same(char *s1, char *s2)
+{
+    while (*s1) {
+	if (*s1++ != *s2++)
+	    test_fail();
+    }
+    if (*s2)
+	test_fail();
 }
 
 /******************************************************************************
@@ -1,7 +1,7 @@
 /*
  *  File name:  test_clock.c
  *  Date first: 06/17/2020
- *  Date last:  06/18/2020
+ *  Date last:  10/17/2026
  *
  *  Description: Test/Example to verify lib_clock.
  *
@@ -19,9 +19,11 @@
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
 #include "lib_board.h"
 #include "lib_clock.h"
+#include "lib_fastdec.h"
 #include "lib_uart.h"
 
 volatile char	clock_tenths;	/* 1/10 second counter 0-255 */
@@ -49,6 +51,8 @@ void local_setup(void); /* setup for this project */
  *  Test the lib_clock library.
  *  Go through tests to verify the calendar function.
  *  Output results to UART.
+ *  Built with -DSIM, the test starts without a key and stops the
+ *  simulator when done.
  */
 
 int main() {
@@ -56,16 +60,20 @@ int main() {
     char	time[10];
     char	dec[6];
     char	last_tenth;
+    uint32_t	start;
 
     board_init(0);
     local_setup();
     clock_init(clock_ms, clock_10);
     uart_init(BAUD_115200);
+    bench_init();
 
     uart_puts("Press any key to start calendar test.\r\n"
 	      "This will print every day from year 2000\r\n"
 	      "to the end of 2009. Turn on your capture file!\r\n");
+#ifndef SIM
     uart_get();
+#endif
     last_tenth = 0;
     do {
 	while (last_tenth == clock_tenths);
@@ -74,9 +82,12 @@ int main() {
 	uart_puts(time);
 	uart_put('\r');
 
+#ifndef SIM
 	if (uart_rsize() == 0)
 	    continue;
+#endif
 	uart_puts("\r\nCalendar test start.\r\n");
+	start = bench_read32();
 
 	date.year  = 2000;
 	date.month = 1;		/* January */
@@ -89,15 +100,15 @@ int main() {
 	    uart_puts(dec);
 	    uart_put(' ');
 	    
-	    bin8_dec2(date.month, dec);
+	    bin8_dec2_fast(date.month, dec);
 	    uart_puts(dec);
 	    uart_put(' ');
 	    
-	    bin8_dec2(date.date, dec);
+	    bin8_dec2_fast(date.date, dec);
 	    uart_puts(dec);
 	    uart_put(' ');
 	    
-	    bin8_dec2(date.day, dec);
+	    bin8_dec2_fast(date.day, dec);
 	    uart_puts(dec);
 	    uart_put(' ');
 	    uart_puts(days[date.day]);
@@ -109,7 +120,8 @@ int main() {
 		uart_crlf();	/* separate the months */
 	}
 	uart_puts("Calendar test complete.\n\r");
-	while (1);
+	bench_phase(1, bench_read32() - start);
+	bench_stop();
     } while (1);
 }
 
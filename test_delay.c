@@ -1,7 +1,7 @@
 /*
  *  File name:  test_delay.c
  *  Date first: 09/16/2022
- *  Date last:  09/17/2022
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for delay library.
  *
@@ -18,13 +18,17 @@
  *  delay_50us()
  *  delay_usecs()
  *  delay_ms()
+ *
+ *  Built with -DSIM ("make sim"), time each one in cycles instead.
  */
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_board.h"
 #include "lib_clock.h"
 #include "lib_delay.h"
+#include "lib_uart.h"
 
 void timer_ms(void);	/* millisecond timer call */
 void timer_10(void);	/* 1/10 second timer call */
@@ -40,6 +44,18 @@ void test_4(void);	/* Test delay_ms() */
 
 #define TEST_LENGTH 50	/* Duration of each test, in 1/10 second. */
 
+/*
+ *  Time each delay with the cycle counter, print the counts to the
+ *  UART, and stop. No oscilloscope is needed.
+ */
+//#define BENCH_DELAY
+
+#ifdef SIM
+#define BENCH_DELAY
+#endif
+
+void bench_delay(void);
+
 /* Using pin A3 (high speed) for output to scope. */
 
 #define PORT_DDR	PA_DDR
@@ -59,6 +75,9 @@ int main() {
     board_init(0);
     local_setup();
     clock_init(timer_ms, timer_10);
+#ifdef BENCH_DELAY
+    bench_delay();
+#endif
 
     /* Choose one test to run at a time. */
     
@@ -145,6 +164,50 @@ void test_4(void)
     }
 }
 
+#ifdef BENCH_DELAY
+/******************************************************************************
+ *
+ *  Cycles for each delay (BENCH_DELAY)
+ *  PHASE 1-4 are DELAY_CALLS calls of delay_500ns(), delay_50us(),
+ *  delay_usecs(100), and delay_ms(10). At 16 mhz, that should be
+ *  8, 800, 1600, and 160000 cycles per call, plus the loop.
+ */
+
+#define DELAY_CALLS	10
+
+void bench_delay(void)
+{
+    uint32_t	start;
+    char	i;
+
+    uart_init(BAUD_115200);
+    bench_init();
+    uart_puts("Delay cycles, 10 calls each\r\n");
+
+    start = bench_read32();
+    for (i = 0; i < DELAY_CALLS; i++)
+	delay_500ns();
+    bench_phase(1, bench_read32() - start);
+
+    start = bench_read32();
+    for (i = 0; i < DELAY_CALLS; i++)
+	delay_50us();
+    bench_phase(2, bench_read32() - start);
+
+    start = bench_read32();
+    for (i = 0; i < DELAY_CALLS; i++)
+	delay_usecs(100);
+    bench_phase(3, bench_read32() - start);
+
+    start = bench_read32();
+    for (i = 0; i < DELAY_CALLS; i++)
+	delay_ms(10);
+    bench_phase(4, bench_read32() - start);
+
+    bench_stop();
+}
+#endif /* BENCH_DELAY */
+
 /******************************************************************************
  *
  *  Board and globals setup
@@ -1,7 +1,7 @@
 /*
  *  File name:  test_flash.c
  *  Date first: 10/17/2018
- *  Date last:  10/19/2018
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for Flash library
  *
@@ -16,11 +16,84 @@
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
+#include "lib_crc.h"
 #include "lib_flash.h"
+#include "lib_flashblk.h"
+#include "lib_format.h"
+#include "lib_kvlog.h"
 #include "lib_uart.h"
 
+/*
+ *  Define TEST_KVLOG to test the key/value store instead of the memory
+ *  test. It counts boots, and writes a counter every second so that the
+ *  areas fill and compact (about every two minutes, so do not leave it
+ *  running for days). Reset the board at any time; the values must
+ *  survive.
+ */
+//#define TEST_KVLOG
+
+#ifdef STM8105
+#define KV_START	0xf800		/* two areas to end of flash */
+#else
+#define KV_START	0x9800
+#endif
+#define KV_BASE		((char *)KV_START)
+#define KV_AREA		0x400
+
+#define KEY_BOOTS	1
+#define KEY_SETPOINT	2
+#define KEY_COUNTER	3
+
+/*
+ *  Define TEST_BLOCK to time byte writes against block writes (standard,
+ *  and erase then fast) over the memory test area, then stop. Timer 1
+ *  counts milliseconds for this, since interrupts are off during each
+ *  block write.
+ */
+//#define TEST_BLOCK
+
+/*
+ *  Define TEST_CRC to check the program image at boot, then time the
+ *  CRC routines over it (PHASE 1 is CRC-32, PHASE 2 is CRC-16). The
+ *  first boot (EEPROM reference is zero) stores the CRC-32. Clear it
+ *  after loading a new program.
+ */
+//#define TEST_CRC
+
+#ifdef SIM
+#define TEST_CRC	/* Only CPU work; starts without a key. */
+#endif
+
+#define IMAGE_BASE	((char *)0x8000)	/* program, to image_end() */
+#define IMAGE_CRC	((uint32_t *)0x4000)	/* reference in EEPROM */
+
+/*
+ *  Memory test area. It starts at FREE_BASE from the Makefile, which
+ *  checks after linking that the program ends below it, and stops at
+ *  the key/value areas, so the memory test leaves the stored values
+ *  alone.
+ */
+#ifndef FREE_BASE
+#error FREE_BASE comes from the Makefile
+#endif
+#if FREE_BASE + 0x800 > KV_START
+#error Memory test area (0x800 bytes) overlaps the key/value areas
+#endif
+#define MEM_BASE	((char *)FREE_BASE)
+#define MEM_SIZE	((int)(KV_START - FREE_BASE))
+#ifdef STM8105
+#define CYCLES_MS	8000	/* 8 mhz crystal */
+#else
+#define CYCLES_MS	16000
+#endif
+
 void setup(void);
+void kvlog_test(void);
+void block_test(char *, int);
+void crc_test(void);
+char *image_end(void);
 
 char clock_1ms;         /* milliseconds 0-255 */
 char clock_ms;          /* milliseconds 0-99 */
@@ -31,6 +104,8 @@ char clock_secs;
 
 static void mem_write (char *, int, char);	/* write block */
 static int  mem_verify(char *, int, char);	/* verify block */
+static void blk_write (char *, int, char, char);	/* write by blocks */
+static void blk_report(char *, uint32_t, int);	/* print msecs, errors */
 
 const char primes[] = {
      3,  5,  7, 11, 13, 17, 19, 23, 29, 31,
@@ -66,19 +141,26 @@ int main() {
     i = 0;
     count = 0;
 
+#ifndef SIM
     uart_get();
+#endif
+#ifdef TEST_KVLOG
+    kvlog_test();
+#endif
+#ifdef TEST_BLOCK
+    block_test(MEM_BASE, MEM_SIZE);
+#endif
+#ifdef TEST_CRC
+    crc_test();
+#endif
     uart_puts("Memory test starting.\r\n");
 
     do {
 	while (last_tenth == clock_tenths);
 	last_tenth = clock_tenths;
 
-	ptr = (char *)0x8800;
-#ifdef STM8105
-	size = 0x3800;
-#else
-	size = 0x1800;
-#endif
+	ptr = MEM_BASE;
+	size = MEM_SIZE;
 	iv = 17;
 
 	retval = flash_unlock();
@@ -111,7 +193,7 @@ int main() {
 	flash_clear(ptr + 0x0087, 0x100);
 	flash_clear(ptr + 0x0200, 0x043);
 	flash_clear(ptr + 0x0400, 0x155);
-	flash_clear(ptr + 0x1234, 0x200);
+	flash_clear(ptr + 0x0534, 0x200);	/* all below 0x800 */
 #ifdef STM8105
 	flash_clear(ptr + 0x3000, 0x100);
 #endif
@@ -120,6 +202,198 @@ int main() {
     } while(1);
 }
 
+#ifdef TEST_KVLOG
+/******************************************************************************
+ *
+ *  Key/value store test (TEST_KVLOG)
+ */
+
+void kvlog_test(void)
+{
+    char	line[64];
+    char	last_tenth, keys;
+    int		boots, setpoint, counter;
+
+    flashblk_init();		/* compaction writes blocks */
+    keys = kv_init(KV_BASE, KV_AREA);
+    boots = 0;
+    counter = 0;
+    setpoint = 720;		/* 72.0 degrees */
+    kv_get(KEY_BOOTS, (char *)&boots, sizeof(boots));
+    kv_get(KEY_COUNTER, (char *)&counter, sizeof(counter));
+    boots++;
+    kv_put(KEY_BOOTS, (char *)&boots, sizeof(boots));
+    kv_put(KEY_SETPOINT, (char *)&setpoint, sizeof(setpoint));
+
+    fmt_line(line, "Keys: %u Boots: %u Counter: %u Seq: %u Free: %u\r\n",
+	     keys, boots, counter, kv_seq(), kv_free());
+    uart_puts(line);
+
+    last_tenth = clock_tenths;
+    do {
+	while (last_tenth == clock_tenths);
+	last_tenth = clock_tenths;
+	if (clock_tenths)
+	    continue;
+
+	counter++;
+	if (kv_put(KEY_COUNTER, (char *)&counter, sizeof(counter)))
+	    uart_puts("kv_put failed\r\n");
+	/* unchanged value, so nothing is written */
+	kv_put(KEY_SETPOINT, (char *)&setpoint, sizeof(setpoint));
+	fmt_line(line, "Counter: %u Seq: %u Free: %u\r\n",
+		 counter, kv_seq(), kv_free());
+	uart_puts(line);
+    } while (1);
+}
+#endif /* TEST_KVLOG */
+
+#ifdef TEST_BLOCK
+/******************************************************************************
+ *
+ *  Byte and block write timing (TEST_BLOCK)
+ *  in: start, size (multiple of FLASHBLK_SIZE)
+ */
+
+void block_test(char *ptr, int size)
+{
+    uint32_t	start;
+    char	*blk;
+    int		left;
+
+    bench_init_ms();		/* a wrap is 65 seconds, not 4 msecs */
+    flashblk_init();
+    uart_puts("Write timing:\r\n");
+
+    start = bench_read32();
+    mem_write(ptr, size, 17);
+    blk_report("Byte", start, mem_verify(ptr, size, 17));
+
+    start = bench_read32();
+    blk_write(ptr, size, 29, FLASHBLK_STANDARD);
+    blk_report("Block standard", start, mem_verify(ptr, size, 29));
+
+    start = bench_read32();
+    for (blk = ptr, left = size; left > 0; left -= FLASHBLK_SIZE) {
+	flashblk_erase(blk);
+	blk += FLASHBLK_SIZE;
+    }
+    blk_report("Block erase", start, mem_verify(ptr, size, 0));
+
+    start = bench_read32();
+    blk_write(ptr, size, 37, FLASHBLK_FAST);
+    blk_report("Block fast", start, mem_verify(ptr, size, 37));
+
+    bench_stop();
+}
+
+/******************************************************************************
+ *
+ *  Write pseudo-random pattern by blocks (same as mem_write)
+ *
+ *  in: start, size, interval, FLASHBLK_STANDARD or FLASHBLK_FAST
+ */
+
+static void blk_write(char *ptr, int size, char iv, char mode)
+{
+    static char	buf[FLASHBLK_SIZE];
+    char	val, i;
+
+    val = 0;
+    for (; size > 0; size -= FLASHBLK_SIZE) {
+	for (i = 0; i < FLASHBLK_SIZE; i++) {
+	    buf[i] = val;
+	    val += iv;
+	}
+	flashblk_write(ptr, buf, mode);
+	ptr += FLASHBLK_SIZE;
+    }
+}
+
+/******************************************************************************
+ *
+ *  Print time and errors of one timing
+ *
+ *  in: name, starting millisecond count, errors
+ */
+
+static void blk_report(char *name, uint32_t start, int errors)
+{
+    char	line[64];
+    uint32_t	ms;
+
+    ms = bench_read32() - start;
+    fmt_line(line, "%s: %lu ms, %u errors\r\n", name, ms, errors);
+    uart_puts(line);
+}
+#endif /* TEST_BLOCK */
+
+#ifdef TEST_CRC
+/******************************************************************************
+ *
+ *  Program image check and CRC speed (TEST_CRC)
+ */
+
+void crc_test(void)
+{
+    char	line[64];
+    uint32_t	start, cycles, crc32, ref;
+    uint16_t	crc16;
+    int		size;
+
+    bench_init();
+    size = image_end() - IMAGE_BASE;
+
+    start = bench_read32();
+    crc32 = CRC32_FINAL(crc32_update(CRC32_INIT, IMAGE_BASE, size));
+    cycles = bench_read32() - start;
+    bench_phase(1, cycles);
+
+    ref = *IMAGE_CRC;
+    if (!ref) {
+	flash_unlock();
+	*IMAGE_CRC = crc32;
+	flash_lock();
+	uart_puts("Image CRC stored.\r\n");
+    }
+    else if (ref != crc32)
+	uart_puts("Image CRC mismatch!\r\n");
+    else
+	uart_puts("Image CRC OK.\r\n");
+
+    fmt_line(line, "CRC-32 %x%x%x%x: %lu bytes/ms\r\n",
+	     (uint16_t)(crc32 >> 24), (uint16_t)(crc32 >> 16),
+	     (uint16_t)(crc32 >> 8), (uint16_t)crc32,
+	     size * (uint32_t)CYCLES_MS / cycles);
+    uart_puts(line);
+
+    start = bench_read32();
+    crc16 = crc16_update(CRC16_INIT, IMAGE_BASE, size);
+    cycles = bench_read32() - start;
+    bench_phase(2, cycles);
+    fmt_line(line, "CRC-16 %x%x: %lu bytes/ms\r\n",
+	     crc16 >> 8, crc16, size * (uint32_t)CYCLES_MS / cycles);
+    uart_puts(line);
+
+    bench_stop();
+}
+
+/******************************************************************************
+ *
+ *  End of program image, from the linker
+ *  out: first address past the CODE area, which sdld places last
+ */
+
+char *image_end(void) __naked
+{
+    __asm
+	ldw	x, #s_CODE
+	addw	x, #l_CODE
+	ret
+    __endasm;
+}
+#endif /* TEST_CRC */
+
 /******************************************************************************
  *
  *  Verify memory
@@ -1,7 +1,7 @@
 /*
  *  File name:  test_gpio_int.c
  *  Date first: 09/28/2022
- *  Date last:  09/30/2022
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for STM8 GPIO interrupts.
  *
@@ -28,6 +28,9 @@
  *  01: Interrupt on rising edge only.
  *  10: Interrupt on falling edge only.
  *  11: Interrupt on rising and falling edge.
+ *
+ *  "make sim" skips this test: the simulator has no jumper from C3 to
+ *  C4, so the interrupt never happens.
  */
 
 #include "stm8s_header.h"
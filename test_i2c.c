@@ -1,7 +1,7 @@
 /*
  *  File name:  test_i2c.c
  *  Date first: 09/21/2022
- *  Date last:  09/21/2022
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for STM8 I2C library.
  *
@@ -19,13 +19,17 @@
  *
  *  Every second, send a series of I2C bytes.
  *  Verify with decoding oscilloscope.
+ *
+ *  Built with -DSIM ("make sim"), time the series instead.
  */
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_board.h"
 #include "lib_clock.h"
 #include "lib_i2c.h"
+#include "lib_uart.h"
 
 void timer_ms(void);	/* millisecond timer call */
 void timer_10(void);	/* 1/10 second timer call */
@@ -35,6 +39,18 @@ volatile unsigned int clock_tenths;
 void local_setup(void);
 void send_series(unsigned char, unsigned char);
 
+/*
+ *  Time the series of bytes with the cycle counter, print the count to
+ *  the UART, and stop. Nothing needs to answer; NAKs are ignored.
+ */
+//#define BENCH_I2C
+
+#ifdef SIM
+#define BENCH_I2C
+#endif
+
+void bench_i2c(void);
+
 /******************************************************************************
  *
  *  Test the I2C library.
@@ -48,6 +64,9 @@ int main() {
     local_setup();
     clock_init(timer_ms, timer_10);
     i2c_init();
+#ifdef BENCH_I2C
+    bench_i2c();
+#endif
 
     clock_last = clock_tenths;
     for (;;) {
@@ -76,6 +95,33 @@ void send_series(unsigned char val, unsigned char count)
     i2c_stop();
 }
 
+#ifdef BENCH_I2C
+/******************************************************************************
+ *
+ *  Cycles for the series (BENCH_I2C)
+ *  PHASE 1 is I2C_SERIES series of 4 bytes, with start and stop.
+ */
+
+#define I2C_SERIES	10
+
+void bench_i2c(void)
+{
+    uint32_t	start;
+    char	i;
+
+    uart_init(BAUD_115200);
+    bench_init();
+    uart_puts("I2C series cycles\r\n");
+
+    start = bench_read32();
+    for (i = 0; i < I2C_SERIES; i++)
+	send_series(i * 4, 4);
+    bench_phase(1, bench_read32() - start);
+
+    bench_stop();
+}
+#endif /* BENCH_I2C */
+
 /******************************************************************************
  *
  *  Board and globals setup
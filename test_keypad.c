@@ -1,7 +1,7 @@
 /*
  *  File name:  test_keypad.c
  *  Date first: 10/13/2018
- *  Date last:  10/30/2018
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for keypad library
  *
@@ -12,13 +12,43 @@
  *
  ******************************************************************************
  *
+ *  Built with -DSIM ("make sim"), time the polls instead.
  */
 
+#include <stdint.h>
+
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
+#include "lib_fastdec.h"
 #include "lib_keypad.h"
+#include "lib_keyq.h"
 #include "lib_uart.h"
 
+/*
+ *  KEYQ passes keypad events through lib_keyq in the timer interrupt,
+ *  so a slow main loop loses none. Each line shows the millisecond
+ *  time, and long press, repeat, and two keys together are shown.
+ *  lib_keypad still queues its own events first; the timer takes all
+ *  of them every millisecond, so only a burst that fills that queue
+ *  within one poll is lost.
+ */
+#define KEYQ
+#define KEY_LONG	600	/* ms to long press */
+#define KEY_REPEAT	150	/* ms between repeats after that */
+
+/*
+ *  Time the keypad poll (and lib_keyq with KEYQ) with the cycle counter,
+ *  print the counts to the UART, and stop. No keypad is needed.
+ */
+//#define BENCH_KEYPAD
+
+#ifdef SIM
+#define BENCH_KEYPAD
+#endif
+
+void bench_keypad(void);
+
 void setup(void);
 
 char clock_1ms;         /* milliseconds 0-255 */
@@ -50,6 +80,17 @@ const KP_PIN cfg_cols[] = {
 /*  Keymap is Digits plus * # A-D */
 static char key_map[] = "147*2580369#ABCD";
 
+#ifdef KEYQ
+/*  lib_keypad gives key numbers 1-16, and lib_keyq maps them */
+static char key_nums[] = "\x01\x02\x03\x04\x05\x06\x07\x08"
+			 "\x09\x0a\x0b\x0c\x0d\x0e\x0f\x10";
+static uint16_t	key_down;	/* bit per key_map entry */
+
+const char *key_types[] = {
+    "", "", " (released)", " (chord)", " (long)", " (repeat)"
+};
+#endif
+
 /******************************************************************************
  *
  *  Test the keypad library
@@ -58,11 +99,25 @@ static char key_map[] = "147*2580369#ABCD";
 int main() {
     char	last_tenth;
     char	key;
+#ifdef KEYQ
+    KEYQ_EVENT	ev;
+    char	decimal[6];
+#endif
 
+#ifdef KEYQ
+    keyq_init(key_map, KEY_LONG, KEY_REPEAT);
+#endif
     setup();
     keypad_init(cfg_rows, cfg_cols);
+#ifdef KEYQ
+    keypad_kmap(key_nums);
+#else
     keypad_kmap(key_map);
+#endif
     uart_init(BAUD_115200);
+#ifdef BENCH_KEYPAD
+    bench_keypad();
+#endif
 
     last_tenth = 0;
     key = 0;
@@ -71,6 +126,16 @@ int main() {
 	if (last_tenth != clock_tenths) {
 	    last_tenth = clock_tenths;
 	}
+#ifdef KEYQ
+	if (!keyq_get(&ev))
+	    continue;
+	bin16_dec_fast(ev.time, decimal);
+	uart_puts(decimal);
+	uart_puts(" Got key :");
+	uart_put(ev.code);
+	uart_puts((char *)key_types[ev.type]);
+	uart_crlf();
+#else
 	key = keypad_getc();
 	if (!key)
 	    continue;
@@ -79,11 +144,48 @@ int main() {
 	if (key & 0x80)
 	    uart_puts(" (released)");
 	uart_crlf();
+#endif
 
 
     } while(1);
 }
 
+#ifdef BENCH_KEYPAD
+/******************************************************************************
+ *
+ *  Cycles for polls (BENCH_KEYPAD)
+ *  PHASE 1 is BENCH_POLLS keypad polls, PHASE 2 as many keyq_poll()
+ *  calls (KEYQ), with no keys down.
+ */
+
+#define BENCH_POLLS	1000
+
+void bench_keypad(void)
+{
+    uint32_t	start;
+    int		i;
+
+    TIM4_IER = 0;		/* no polls from the timer */
+    bench_init();
+    uart_puts("Keypad poll cycles\r\n");
+
+    start = bench_read32();
+    for (i = 0; i < BENCH_POLLS; i++) {
+	keypad_poll();
+	keypad_getc();
+    }
+    bench_phase(1, bench_read32() - start);
+#ifdef KEYQ
+    start = bench_read32();
+    for (i = 0; i < BENCH_POLLS; i++)
+	keyq_poll(0);
+    bench_phase(2, bench_read32() - start);
+#endif
+
+    bench_stop();
+}
+#endif /* BENCH_KEYPAD */
+
 /******************************************************************************
  *
  *  Board and globals setup
@@ -129,6 +231,11 @@ void setup(void)
 
 void timer4_isr(void) __interrupt (IRQ_TIM4)
 {
+#ifdef KEYQ
+    uint16_t	bit;
+    char	key;
+#endif
+
     TIM4_SR = 0;		/* clear the interrupt */
 
     /* Profiling with Timer4 gives 36 uSecs per keyboard poll.
@@ -136,6 +243,16 @@ void timer4_isr(void) __interrupt (IRQ_TIM4)
      * milliseconds will be fine.
      */
     keypad_poll();
+#ifdef KEYQ
+    while ((key = keypad_getc())) {	/* all of them, to key bits */
+	bit = (uint16_t)1 << ((key & 0x7f) - 1);
+	if (key & 0x80)
+	    key_down &= ~bit;
+	else
+	    key_down |= bit;
+    }
+    keyq_poll(key_down);
+#endif
 
     clock_1ms++;
     clock_ms++;
@@ -1,7 +1,7 @@
 /*
  *  File name:  test_lcd.c
  *  Date first: 12/31/2018
- *  Date last:  08/07/2019
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for LCD library.
  *
@@ -12,13 +12,16 @@
  *
  ******************************************************************************
  *
+ *  Built with -DSIM ("make sim"), time the screen writes instead.
  */
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
 #include "lib_clock.h"
 #include "lib_lcd.h"
+#include "lib_uart.h"
 
 void timer_ms(void);	/* millisecond timer call */
 void timer_10(void);	/* 1/10 second timer call */
@@ -26,6 +29,19 @@ void timer_10(void);	/* 1/10 second timer call */
 char clock_tenths;
 
 void setup(void);
+void show_screen(int);
+
+/*
+ *  Time full screen writes and clears with the cycle counter, print the
+ *  counts to the UART, and stop.
+ */
+//#define BENCH_LCD
+
+#ifdef SIM
+#define BENCH_LCD
+#endif
+
+void bench_lcd(void);
 
 static void test_keys(void);
 static void show_status(void);
@@ -40,13 +56,15 @@ static char module_type;
  */
 
 int main() {
-    char	 dbuf[12];
-    char	 clock_last, i;
+    char	 clock_last;
     int		 count16;
 
     setup();
     clock_init(timer_ms, timer_10);
     lcd_init();
+#ifdef BENCH_LCD
+    bench_lcd();
+#endif
 
     count16 = 0;
     clock_last = 0;
@@ -63,31 +81,77 @@ int main() {
 	if (clock_last & 7)
 	    continue;
 
-	lcd_curs(0, 0);
+	show_screen(count16);
 
-	clock_string(dbuf);
-	lcd_puts(dbuf);
-	lcd_putc(' ');
+	count16++;
+	if (!(count16 & 7))	/* test clear every 8 passes */
+	    lcd_clear();
+    } while(1);
+}
 
-	bin16_dec_rlz(count16, dbuf);
-	lcd_puts(dbuf);
+/******************************************************************************
+ *
+ *  Write all four lines
+ *  in: pass count
+ */
 
-	lcd_puts(" 67890");
+void show_screen(int count16)
+{
+    char	 dbuf[12];
+    char	 i;
 
-	lcd_curs(1, 0);
-	for (i = 0; i < 20; i++)
-	    lcd_putc((count16 & 31) + i + 'A');
+    lcd_curs(0, 0);
 
-	lcd_curs(2, 0);
-	lcd_puts("Line #3..01234567890");
-	lcd_curs(3, 0);
-	lcd_puts("Line #4 !@#$%^&*()_-");
+    clock_string(dbuf);
+    lcd_puts(dbuf);
+    lcd_putc(' ');
 
-	count16++;
-	if (!(count16 & 7))	/* test clear every 8 passes */
-	    lcd_clear();
-    } while(1);
+    bin16_dec_rlz(count16, dbuf);
+    lcd_puts(dbuf);
+
+    lcd_puts(" 67890");
+
+    lcd_curs(1, 0);
+    for (i = 0; i < 20; i++)
+	lcd_putc((count16 & 31) + i + 'A');
+
+    lcd_curs(2, 0);
+    lcd_puts("Line #3..01234567890");
+    lcd_curs(3, 0);
+    lcd_puts("Line #4 !@#$%^&*()_-");
+}
+
+#ifdef BENCH_LCD
+/******************************************************************************
+ *
+ *  Cycles for screen writes (BENCH_LCD)
+ *  PHASE 1 is LCD_SCREENS full screens, PHASE 2 as many clears.
+ */
+
+#define LCD_SCREENS	8
+
+void bench_lcd(void)
+{
+    uint32_t	start;
+    char	i;
+
+    uart_init(BAUD_115200);
+    bench_init();
+    uart_puts("LCD screen cycles\r\n");
+
+    start = bench_read32();
+    for (i = 0; i < LCD_SCREENS; i++)
+	show_screen(i);
+    bench_phase(1, bench_read32() - start);
+
+    start = bench_read32();
+    for (i = 0; i < LCD_SCREENS; i++)
+	lcd_clear();
+    bench_phase(2, bench_read32() - start);
+
+    bench_stop();
 }
+#endif /* BENCH_LCD */
 
 /******************************************************************************
  *
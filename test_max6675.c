@@ -1,7 +1,7 @@
 /*
  *  File name:  test_max6675.c
  *  Date first: 12/12/2022
- *  Date last:  12/12/2022
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for MAX6675 thermocouple library.
  *
@@ -24,13 +24,16 @@
  *  D3: SPI clock (out)
  *  A1: SPI in (MISO)
  *  A2: CS* (slow pin)
+ *
+ *  Built with -DSIM ("make sim"), time the reads instead.
  */
 
 #include "stm8s_header.h"
 
-#include "lib_bindec.h"
+#include "lib_bench.h"
 #include "lib_board.h"
 #include "lib_clock.h"
+#include "lib_format.h"
 #include "lib_max6675.h"
 #include "lib_uart.h"
 
@@ -43,6 +46,19 @@ void local_setup(void);
 
 void show_temp(void);	/* Output current temperature. */
 
+/*
+ *  Time the reads with the cycle counter, print the count to the UART,
+ *  and stop. Without a MAX6675 the reads come back as errors, which
+ *  take the same time.
+ */
+//#define BENCH_MAX6675
+
+#ifdef SIM
+#define BENCH_MAX6675
+#endif
+
+void bench_max6675(void);
+
 /******************************************************************************
  *
  *  Test the MAX6675 library.
@@ -58,6 +74,9 @@ int main() {
     uart_init(BAUD_115200);
 
     uart_puts("Now testing MAX6675 thermocouple device.\r\n");
+#ifdef BENCH_MAX6675
+    bench_max6675();
+#endif
 
     clock_last = clock_tenths;
     for (;;) {
@@ -77,27 +96,49 @@ int main() {
 void show_temp(void)
 {
     int16_t	tempc;		/* Temperature, in 0.25C */
-    char	dec[9];
-    const char *frac[4] = {".00", ".25", ".50", ".75"};
+    int16_t	tempf;		/* Temperature, in 0.25F */
+    char	line[24];
 
     tempc = max6675_read();
     if (tempc == MAX6675_ERROR) {
 	uart_puts("Error: Check thermocouple.\r\n");
 	return;
     }
-    /* Show temperature in Celcius. */
-    uart_puts(bin16_dec_rlz(tempc >> 2, dec));
-    uart_puts(frac[tempc & 3]);
-    uart_puts("C    ");
-    
-    /* Show temperature in Fahrenheit. */
-    tempc *= 9;
-    tempc /= 5;
-    tempc += 32 << 2;
-    uart_puts(bin16_dec_rlz(tempc >> 2, dec));
-    uart_puts(frac[tempc & 3]);
-    uart_puts("F\r\n");
+    tempf = tempc * 9;
+    tempf /= 5;
+    tempf += 32 << 2;
+
+    /* Show temperature in Celcius and Fahrenheit. */
+    fmt_line(line, "%d.%02uC    %d.%02uF\r\n",
+	     tempc >> 2, (tempc & 3) * 25,
+	     tempf >> 2, (tempf & 3) * 25);
+    uart_puts(line);
+}
+
+#ifdef BENCH_MAX6675
+/******************************************************************************
+ *
+ *  Cycles for reads (BENCH_MAX6675)
+ *  PHASE 1 is MAX6675_READS calls of max6675_read().
+ */
+
+#define MAX6675_READS	10
+
+void bench_max6675(void)
+{
+    uint32_t	start;
+    char	i;
+
+    bench_init();
+    start = bench_read32();
+    for (i = 0; i < MAX6675_READS; i++)
+	max6675_read();
+    bench_phase(1, bench_read32() - start);
+
+    show_temp();
+    bench_stop();
 }
+#endif /* BENCH_MAX6675 */
 
 /******************************************************************************
  *
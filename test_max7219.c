@@ -1,7 +1,7 @@
 /*
  *  File name:  test_max7219.c
  *  Date first: 03/15/2018
- *  Date last:  08/07/2019
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program MAX7219 LED controller.
  *
@@ -14,11 +14,17 @@
  *
  */
 
+#include <stdint.h>
+
 #include "stm8_103.h"
 #include "vectors.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
+#include "lib_format.h"
+#include "lib_m7219fb.h"
 #include "lib_max7219.h"
+#include "lib_uart.h"
 
 /* Choose one of the following three test options */
 
@@ -38,6 +44,39 @@
 /* Use the following if you have 3 7-segment modules connected together (3x8 digits) */
 #define MODULE_CT	3
 
+/*
+ * Use lib_m7219fb instead (hardware SPI, LOAD on C4).
+ * With MAX7219_7SEG, the modules use Code-B decode, and only the digit
+ * rows that changed are sent. Line 0 is the clock, line 2 the counter,
+ * and line 1 shows how many rows the last update sent.
+ * With MAX7219_DOT and GRAPHIC_MARQUEE, the marquee scrolls one column
+ * every MARQUEE_MS from the timer interrupt, and the main loop is idle.
+ */
+//#define FRAMEBUFFER
+#define MARQUEE_MS	30
+
+/*
+ * Benchmark m7fb_blit() full-frame refresh for chains of 1 to 16
+ * modules, print the results to the UART, and stop. This only needs
+ * the STM8 (and the simulator); the modules do not have to be there.
+ */
+//#define BENCH_BLIT
+
+#ifdef SIM
+#define FRAMEBUFFER
+#define BENCH_BLIT
+#endif
+#if defined(BENCH_BLIT) && !defined(FRAMEBUFFER)
+#error BENCH_BLIT needs FRAMEBUFFER
+#endif
+
+#if defined(FRAMEBUFFER) && LED_MODE == MAX7219_GRAPH
+#error FRAMEBUFFER is for MAX7219_7SEG or MAX7219_DOT
+#endif
+#if defined(FRAMEBUFFER) && LED_MODE == MAX7219_DOT && !defined(GRAPHIC_MARQUEE)
+#error FRAMEBUFFER with MAX7219_DOT is for GRAPHIC_MARQUEE
+#endif
+
 char clock_ms;		/* milliseconds */
 char clock_10;		/* 1/10 second 0-255 */
 char clock_tenths;
@@ -47,6 +86,7 @@ char clock_hours;
 
 void setup(void);
 void get_clock(char *);
+void bench_blit(void);
 
 const char marquee[] = "ATTENTION: Flight 121 from Oahu to Los Angeles has "
     "snakes on the plane. Enjoy your flight.  ";
@@ -65,17 +105,31 @@ int main() {
     char	*mptr, *m2, mfrac;
     char	 wptr;
     char	 ac, i;
+    char	 rows;
     int		 clock_last;
     int		 count16;
     
     m2, i;
 
     setup();
+#ifdef BENCH_BLIT
+    bench_blit();
+#endif
+#ifdef FRAMEBUFFER
+#if LED_MODE == MAX7219_7SEG
+    m7fb_init(MODULE_CT, M7FB_CODE_B);
+#else
+    m7fb_init(MODULE_CT, M7FB_RAW);
+    m7fb_marquee(marquee, MARQUEE_MS);
+#endif
+#else
     m7219_init(LED_MODE, MODULE_CT);
+#endif
 
     clock_last = 0;
     count16 = 0;
     ac = ' ';
+    rows = 0;
 
     mptr = marquee;
     mfrac = 0;
@@ -88,6 +142,17 @@ int main() {
 
 	count16++;
 	bin16_dec(count16, decimal);
+#ifdef FRAMEBUFFER
+#if LED_MODE == MAX7219_7SEG
+	m7fb_puts(2, 3, decimal);
+	get_clock(decimal);
+	m7fb_puts(0, 0, decimal);
+	fmt_line(decimal, "%u", rows);	/* rows sent last time */
+	m7fb_puts(1, 7, decimal);
+	rows = m7fb_flush();
+#endif
+	continue;		/* marquee runs from timer */
+#endif
 #if LED_MODE == MAX7219_7SEG
 	m7219_curs(2, 0);
 	m7219_puts(decimal);
@@ -186,6 +251,9 @@ void setup(void)
 void timer4_isr(void) __interrupt (IRQ_TIM4)
 {
     TIM4_SR = 0;		/* clear the interrupt */
+#ifdef FRAMEBUFFER
+    m7fb_tick();
+#endif
 
     clock_ms++;
     if (clock_ms < 100)
@@ -211,6 +279,47 @@ void timer4_isr(void) __interrupt (IRQ_TIM4)
     clock_hours = 0;
 }
 
+#ifdef BENCH_BLIT
+/******************************************************************************
+ *
+ *  Full-frame refresh time for 1 to 16 modules (BENCH_BLIT)
+ *  Output: modules, cycles per frame, microseconds, frames per second
+ *  PHASE n is the cycles per frame for n modules.
+ */
+
+#define BLIT_FRAMES	8	/* frames timed per chain length */
+
+static char	blit_cols[M7FB_MAX * 8];
+
+void bench_blit(void)
+{
+    uint32_t	start, cycles;
+    char	line[48];
+    char	mods, i;
+    int		x;
+
+    uart_init(BAUD_115200);
+    bench_init();
+    uart_puts("m7fb_blit full frame\r\n");
+
+    for (x = 0; x < M7FB_MAX * 8; x++)
+	blit_cols[x] = 1 << (x & 7);	/* diagonal lines */
+
+    for (mods = 1; mods <= M7FB_MAX; mods++) {
+	m7fb_init(mods, M7FB_RAW);
+	start = bench_read32();
+	for (i = 0; i < BLIT_FRAMES; i++)
+	    m7fb_blit(blit_cols);
+	cycles = (bench_read32() - start) / BLIT_FRAMES;
+	bench_phase(mods, cycles);
+	fmt_line(line, "%2u modules: %6lu cycles %5lu usec %5lu/sec\r\n",
+		 mods, cycles, cycles / 16, 16000000 / cycles);
+	uart_puts(line);
+    }
+    bench_stop();
+}
+#endif /* BENCH_BLIT */
+
 /******************************************************************************
  *
  *  Get the clock as string
@@ -224,20 +333,8 @@ void get_clock(char *clk)
 #define CLOCK_SEP ':'
 #endif
 
-    char	decimal[6];
-
-    bin16_dec(clock_hours, decimal);
-    *clk++ = decimal[3];
-    *clk++ = decimal[4];
-    *clk++ = CLOCK_SEP;
-    bin16_dec(clock_mins, decimal);
-    *clk++ = decimal[3];
-    *clk++ = decimal[4];
-    *clk++ = CLOCK_SEP;
-    bin16_dec(clock_secs, decimal);
-    *clk++ = decimal[3];
-    *clk++ = decimal[4];
-    *clk   = 0;
+    fmt_line(clk, "%02u%c%02u%c%02u", clock_hours, CLOCK_SEP,
+	     clock_mins, CLOCK_SEP, clock_secs);
 }
 
 /******************************************************************************
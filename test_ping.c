@@ -1,7 +1,7 @@
 /*
  *  File name:  test_ping.c
  *  Date first: 11/05/2018
- *  Date last:  12/05/2018
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for HC-SR04 ultrasonic range finder.
  *
@@ -16,12 +16,57 @@
 
 #include "stm8s_header.h"
 
-#include "lib_bindec.h"
+#include <stdint.h>
+
+#include "lib_bench.h"
 #include "lib_clock.h"
 #include "lib_delay.h"
-#include "lib_ping.h"
+#include "lib_format.h"
+#include "lib_pingd.h"
+#include "lib_pingf.h"
 #include "lib_uart.h"
 
+/*
+ *  SCHEDULER uses lib_pingx: the pings run from interrupts, one sensor
+ *  after another, and the main loop only prints. Echo pins are D4, D3,
+ *  and A3. Comment it out to use lib_ping with wait_25ms() instead.
+ */
+#define SCHEDULER
+
+#ifdef SCHEDULER
+#include "lib_pingx.h"
+#define DIST_INCH	PINGX_INCH
+#else
+#include "lib_ping.h"
+#define DIST_INCH	PING_INCH
+#endif
+
+/*
+ *  FILTER passes each channel through lib_pingf (median of 5 and an
+ *  average of 1/8) before it is shown, to hide false echoes.
+ */
+//#define FILTER
+#define FILTER_SHIFT	3
+#define FILTER_JUMP	(2 * DIST_INCH)	/* outlier: 2 inches */
+
+/*
+ *  Air temperature for lib_pingd (SCHEDULER), celsius
+ */
+#define AIR_TEMP	20
+
+/*
+ *  Time pingf_add(), and the divide against pingd_inch(), over a trace
+ *  with false and missing echoes. Print the cycles per sample, and
+ *  stop. No sensors are needed. PHASE 1-3 are the total cycles of the
+ *  filter, the divide, and pingd_inch().
+ */
+//#define BENCH_PING
+
+#ifdef SIM
+#define FILTER
+#define BENCH_PING
+#endif
+
 void setup(void);
 
 /* Using pin A2, D1, and D2 for triggers */
@@ -38,7 +83,7 @@ const IO_PIN pin_trig3 = {	/* D2 */
 
 volatile char	clock_tenths;	/* 1/10 second counter 0-255 */
 volatile char   clock_msecs;	/* millisecond counter */
-volatile int	d1, d2, d3;	/* current distances */
+volatile uint16_t d1, d2, d3;	/* current distances */
 volatile int	counts;
 volatile char	flag_count;	/* got new distance count */
 
@@ -53,8 +98,13 @@ void ping_cb1(int);	/* ping channel 1 callback */
 void ping_cb2(int);	/* ping channel 2 callback */
 void ping_cb3(int);	/* ping channel 3 callback */
 
-void print_dist(int);
+char *print_dist(char *, uint16_t);
 void wait_25ms(void);
+void bench_ping(void);
+
+#ifdef FILTER
+PINGF	filter1, filter2, filter3;
+#endif
 
 /* Pins to use as triggers and callback functions */
 
@@ -70,12 +120,27 @@ const IO_CALL_INT ping_cfg[] = {
  */
 
 int main() {
-    char	decimal[10];
+    char	line[48];
+    char	*lp;
     char	last_tenth;
 
     setup();
+#ifdef BENCH_PING
+    bench_ping();
+#endif
+#ifdef FILTER
+    pingf_init(&filter1, FILTER_SHIFT, FILTER_JUMP);
+    pingf_init(&filter2, FILTER_SHIFT, FILTER_JUMP);
+    pingf_init(&filter3, FILTER_SHIFT, FILTER_JUMP);
+#endif
     clock_init(clock_ms, clock_10);
+#ifdef SCHEDULER
+    pingd_temp(AIR_TEMP);
+    pingx_init(3, ping_cfg);
+    pingx_start();
+#else
     ping_init(PING_CHAN1 | PING_CHAN2 | PING_CHAN3, ping_cfg);
+#endif
     uart_init(BAUD_115200);
 
     last_tenth = 0;
@@ -88,17 +153,15 @@ int main() {
 	if (flag_count) {
 	    flag_count = 0;
 
-	    bin16_dec(counts, decimal);
-	    decimal_rlz(decimal, 4);
-	    uart_puts(decimal);
-	    uart_put(' ');
-
-	    print_dist(d1);
-	    print_dist(d2);
-	    print_dist(d3);
+	    lp = fmt_line(line, "%5u ", counts);
+	    lp = print_dist(lp, d1);
+	    lp = print_dist(lp, d2);
+	    print_dist(lp, d3);
 
+	    uart_puts(line);
 	    uart_crlf();
 	}
+#ifndef SCHEDULER
 	d1 = -1;	/* "no echo response" */
 	d2 = -1;
 	d3 = -1;
@@ -108,21 +171,24 @@ int main() {
 	ping_send(PING_CHAN2);
 	wait_25ms();
 	ping_send(PING_CHAN3);
-
+#endif
     } while(1);
 }
 
 /******************************************************************************
  *
  *  Got new ping value (callback)
- *  in: round  trip time in microseconds
+ *  in: round  trip time in microseconds (lib_pingx: 1/2 microseconds)
  *      -1 (0xffff) indicates no echo response.
  */
 
 void ping_cb1(int val)
 {
+#ifdef FILTER
+    val = pingf_add(&filter1, val);
+#endif
     d1 = val;
-    if (val < 0)
+    if ((uint16_t)val == 0xffff)
 	return;
     counts++;
     flag_count = 1;
@@ -130,21 +196,91 @@ void ping_cb1(int val)
 
 void ping_cb2(int val)
 {
+#ifdef FILTER
+    val = pingf_add(&filter2, val);
+#endif
     d2 = val;
-    if (val < 0)
+    if ((uint16_t)val == 0xffff)
 	return;
     counts++;
     flag_count = 1;
 }
 void ping_cb3(int val)
 {
+#ifdef FILTER
+    val = pingf_add(&filter3, val);
+#endif
     d3 = val;
-    if (val < 0)
+    if ((uint16_t)val == 0xffff)
 	return;
     counts++;
     flag_count = 1;
 }
 
+#ifdef BENCH_PING
+/******************************************************************************
+ *
+ *  Cycles for pingf_add() and distance conversion (BENCH_PING)
+ *  The trace is 40 inches (in 1/2 usecs) with noise, false short
+ *  echoes, and misses.
+ */
+
+#define BENCH_PASSES	16
+
+const uint16_t bench_trace[32] = {
+    11842, 11830, 11860,  2420, 11816, 11852, 11838, 11866,
+    11822, 0xffff, 11848, 11834,  1280,  3248, 11858, 11824,
+    11840, 11814, 11870, 11832,  4420, 11844, 11828, 11862,
+    0xffff, 11836, 11850, 11818, 11854, 11826,  1532, 11840
+};
+
+volatile uint16_t bench_sink;
+
+void bench_ping(void)
+{
+    BENCH_STAT	filt, div, conv;
+    PINGF	filter;
+    uint16_t	start, end, val;
+    char	pass, i;
+
+    uart_init(BAUD_115200);
+    bench_init();
+    bench_clear(&filt);
+    bench_clear(&div);
+    bench_clear(&conv);
+    pingf_init(&filter, FILTER_SHIFT, FILTER_JUMP);
+
+    for (pass = 0; pass < BENCH_PASSES; pass++) {
+	for (i = 0; i < 32; i++) {
+	    val = bench_trace[i];
+	    start = bench_read();
+	    pingf_add(&filter, val);
+	    end = bench_read();
+	    bench_add(&filt, end - start);
+	    if (val == 0xffff)
+		continue;
+
+	    start = bench_read();
+	    bench_sink = val / DIST_INCH;
+	    end = bench_read();
+	    bench_add(&div, end - start);
+
+	    start = bench_read();
+	    bench_sink = pingd_inch(val);
+	    end = bench_read();
+	    bench_add(&conv, end - start);
+	}
+    }
+    bench_print("pingf_add cycles", &filt);
+    bench_print("divide cycles", &div);
+    bench_print("pingd_inch cycles", &conv);
+    bench_phase(1, filt.sum);
+    bench_phase(2, div.sum);
+    bench_phase(3, conv.sum);
+    bench_stop();
+}
+#endif /* BENCH_PING */
+
 /******************************************************************************
  *
  *  Wait 25 milliseconds between the triggers
@@ -184,21 +320,20 @@ void clock_10(void)
 
 /******************************************************************************
  *
- *  Print distance
+ *  Print distance into report line
+ *  in: line position, distance
+ *  out: new line position
  */
 
-void print_dist(int dist)
+char *print_dist(char *lp, uint16_t dist)
 {
-    char	decimal[6];
-
-    if (dist < 0) {
-	uart_puts(" no distance ");
-	return;
-    }
-    bin16_dec(dist / PING_INCH, decimal);
-    decimal_rlz(decimal, 4);
-    uart_puts(decimal);
-    uart_puts(" inches ");
+    if (dist == 0xffff)
+	return fmt_line(lp, " no distance ");
+#ifdef SCHEDULER
+    return fmt_line(lp, "%5u inches ", pingd_inch(dist));
+#else
+    return fmt_line(lp, "%5u inches ", dist / DIST_INCH);
+#endif
 }
 
 /******************************************************************************
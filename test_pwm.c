@@ -1,7 +1,7 @@
 /*
  *  File name:  test_pwm.c
  *  Date first: 08/21/2018
- *  Date last:  08/22/2018
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for PWM/servo library
  *
@@ -12,11 +12,14 @@
  *
  ******************************************************************************
  *
+ *  Built with -DSIM ("make sim"), time the updates instead.
  */
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_pwm.h"
+#include "lib_uart.h"
 
 char clock_1ms;		/* milliseconds 0-255 */
 char clock_ms;		/* milliseconds 0-99 */
@@ -29,6 +32,18 @@ void setup(void);
 //#define TEST_DUTY		/* sweep duty cycle over 20 seconds */
 #define TEST_SERVO		/* sweep servo over 5 seconds */
 
+/*
+ *  Time the channel updates of the test chosen above with the cycle
+ *  counter, print the count to the UART, and stop.
+ */
+//#define BENCH_PWM
+
+#ifdef SIM
+#define BENCH_PWM
+#endif
+
+void bench_pwm(void);
+
 /******************************************************************************
  *
  *  Test the PWM/servo library
@@ -44,6 +59,9 @@ int main() {
 #endif
 #ifdef TEST_SERVO
     pwm_init(PWM_SERVO, PWM_C1 | PWM_C2);
+#endif
+#ifdef BENCH_PWM
+    bench_pwm();
 #endif
     clock_last = 0;
     pwm = 0;
@@ -70,6 +88,39 @@ int main() {
     } while(1);
 }
 
+#ifdef BENCH_PWM
+/******************************************************************************
+ *
+ *  Cycles for channel updates (BENCH_PWM)
+ *  PHASE 1 is 200 updates of both channels.
+ */
+
+void bench_pwm(void)
+{
+    uint32_t	start;
+    char	pwm;
+
+    uart_init(BAUD_115200);
+    bench_init();
+    uart_puts("PWM update cycles\r\n");
+
+    start = bench_read32();
+    for (pwm = 0; pwm < 200; pwm++) {
+#ifdef TEST_DUTY
+	pwm_duty(PWM_C1, pwm);
+	pwm_duty(PWM_C2, 200 - pwm);
+#endif
+#ifdef TEST_SERVO
+	pwm_servo(PWM_C1, pwm);
+	pwm_servo(PWM_C2, 192 - pwm);
+#endif
+    }
+    bench_phase(1, bench_read32() - start);
+
+    bench_stop();
+}
+#endif /* BENCH_PWM */
+
 /******************************************************************************
  *
  *  Board and globals setup
@@ -1,7 +1,7 @@
 /*
  *  File name:  test_spi.c
  *  Date first: 06/08/2020
- *  Date last:  07/08/2020
+ *  Date last:  10/17/2026
  *
  *  Description: Test/Example for STM8 SPI Library.
  *
@@ -19,10 +19,13 @@
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
 #include "lib_board.h"
 #include "lib_clock.h"
 #include "lib_delay.h"
+#include "lib_fastdec.h"
+#include "lib_format.h"
 #include "lib_spi.h"
 #include "lib_uart.h"
 
@@ -40,6 +43,7 @@ void dump_hex(char *, char);	/* dump buffer as hex */
 
 void tm1638_command(SPI_CTX *); /* Send TM1638 command. */
 void tm1638_init(SPI_CTX *);	/* Set up TM1638. */
+void test_bench(SPI_CTX *);	/* Throughput benchmark. */
 
 /*
  *  Chose the test to run.
@@ -50,6 +54,11 @@ void tm1638_init(SPI_CTX *);	/* Set up TM1638. */
 //#define TEST_RX	/* Test RX only transaction. */
 #define TEST_TXRX	/* Test combined TX+RX transaction. */
 //#define TEST_TM1638	/* Text bidirectional mode with LED/KEYPAD device. */
+//#define TEST_BENCH	/* Throughput benchmark in loopback, then stop. */
+
+#ifdef SIM
+#define TEST_BENCH	/* Only the benchmark makes sense in the simulator. */
+#endif
 
 /*
  *  Choose whether you want an SPI transaction every millisecond (better
@@ -109,6 +118,9 @@ int main() {
 
     spi_init(&ctx1);
     spi_init(&ctx2);
+#ifdef TEST_BENCH
+    test_bench(&ctx1);
+#endif
     
     last_msec = 0;
     last_tenth = 0;
@@ -209,11 +221,11 @@ void dump_hex(char *buf, char size)
     pos = 0;
     while (size--) {
 	if (!(pos & 15)) {
-	    bin8_hex(pos, hex);
+	    bin8_hex_fast(pos, hex);
 	    uart_puts(hex);
 	    uart_puts(": ");
 	}
-	bin8_hex(*buf++, hex);
+	bin8_hex_fast(*buf++, hex);
 	uart_puts(hex);
 	uart_put(' ');
 	pos++;
@@ -224,6 +236,120 @@ void dump_hex(char *buf, char size)
 	uart_crlf();
 }
 
+#ifdef TEST_BENCH
+/******************************************************************************
+ *
+ *  Throughput benchmark (TEST_BENCH)
+ *  in: SPI context to use
+ *
+ *  Every clock setting and transfer lengths from 1 to 255 bytes, with
+ *  MOSI jumpered to MISO. Each transfer sends the pattern and receives
+ *  the same number of bytes, which must come back unchanged.
+ *
+ *  ISR overhead is the timer equivalent of the A2 ISR marker: the main
+ *  loop counts spins while it waits, and any cycles not spent spinning
+ *  went to the SPI interrupt. The spin is timed first with the same
+ *  spin_wait() on a flag that is never set, stopped by its count.
+ *
+ *  Output: speed, length, bytes/second, ISR cycles per byte, result.
+ *  PHASE n is the cycles of all transfers at speed n (1 is 8M).
+ */
+
+#define BENCH_MAX	255	/* tx_count and rx_count are 8 bits */
+#define SPIN_CAL	1000	/* spins to time one spin */
+#define SPIN_ANY	0xffffffff	/* no spin limit */
+#define SPI_SPEED(n)	((n) << 3)	/* SPI_CR1 baud field: CPU / 2^(n+1) */
+
+static char	bench_tx[BENCH_MAX];
+static char	bench_rx[BENCH_MAX];
+
+const char *bench_names[8] = {
+    "  8M", "  4M", "  2M", "  1M", "500K", "250K", "125K", " 62K"
+};
+const char bench_lens[9] = { 1, 2, 4, 8, 16, 32, 64, 128, BENCH_MAX };
+
+static uint32_t spin_wait(volatile char *, uint32_t);
+
+void test_bench(SPI_CTX *ctx)
+{
+    uint32_t	start, cycles, rate, spin_cycles, isr, total, spins;
+    uint16_t	errors;
+    volatile char never;
+    char	line[64];
+    char	speed, len, i, j;
+
+    bench_init();
+    uart_puts("SPI benchmark (MOSI to MISO)\r\n");
+
+    never = 0;			/* time the wait loop, never done */
+    start = bench_read32();
+    spin_wait(&never, SPIN_CAL);
+    spin_cycles = bench_read32() - start;
+
+    for (i = 0; i < BENCH_MAX; i++)
+	bench_tx[i] = i * 37 + 11;
+    ctx->tx_buf = bench_tx;
+    ctx->rx_buf = bench_rx;
+    ctx->flag_bidir = 0;
+
+    for (speed = 0; speed < 8; speed++) {
+	ctx->config =
+	    SPI_MSB_FIRST |
+	    SPI_SPEED(speed) |
+	    SPI_IDLE_1 |
+	    SPI_EDGE_2;
+	spi_config(ctx);
+	total = 0;
+	for (j = 0; j < sizeof(bench_lens); j++) {
+	    len = bench_lens[j];
+	    for (i = 0; i < len; i++)
+		bench_rx[i] = ~bench_tx[i];
+	    ctx->tx_count = len;
+	    ctx->rx_count = len;
+
+	    start = bench_read32();
+	    spi_start(ctx);
+	    spins = spin_wait((volatile char *)&ctx->flag_done, SPIN_ANY);
+	    spi_wait();
+	    cycles = bench_read32() - start;
+	    total += cycles;
+
+	    errors = 0;
+	    for (i = 0; i < len; i++)
+		if (bench_rx[i] != bench_tx[i])
+		    errors++;
+
+	    rate = (uint32_t)len * 16000000 / cycles;
+	    isr = spin_cycles * spins / SPIN_CAL;
+	    isr = isr < cycles ? (cycles - isr) / len : 0;
+	    fmt_line(line, "%s %3u: %7lu B/s %5lu cyc/B %s%u\r\n",
+		     bench_names[speed], len, rate, isr,
+		     errors ? "ERRORS " : "OK ", errors);
+	    uart_puts(line);
+	}
+	bench_phase(speed + 1, total);
+    }
+    bench_stop();
+}
+
+/******************************************************************************
+ *
+ *  Count spins until flag is set, or limit
+ *  in: flag, spin limit
+ *  out: spins
+ */
+
+static uint32_t spin_wait(volatile char *flag, uint32_t limit)
+{
+    uint32_t	spins;
+
+    spins = 0;
+    while (!*flag && spins != limit)
+	spins++;
+    return spins;
+}
+#endif /* TEST_BENCH */
+
 /******************************************************************************
  *
  *  Set up TM1638
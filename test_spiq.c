@@ -0,0 +1,366 @@
+/*
+ *  File name:  test_spiq.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Test/Example for queued SPI library.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ *  Location:
+ *  https://github.com/unfrozen/stm8_tests
+ *
+ *  Code copied and modified from test_spi.c
+ *
+ ******************************************************************************
+ *
+ *  Every 1/10 second, post a TM1638 update (mode, data, key read) and a
+ *  full-duplex loopback, all in one go. The main loop counts how many
+ *  times it spins while the queue runs, to show that it is free during
+ *  transfers. Every second, print the loopback data, loopback errors,
+ *  keys, and spin count.
+ *
+ *  Connect MOSI (C6) to MISO (C7) for loopback. The TM1638 strobe is A3.
+ *
+ *  Built with -DSIM ("make sim"), time the updates instead.
+ */
+
+#include "stm8s_header.h"
+
+#include "lib_bench.h"
+#include "lib_board.h"
+#include "lib_clock.h"
+#include "lib_fastdec.h"
+#include "lib_format.h"
+#include "lib_spiq.h"
+#include "lib_uart.h"
+
+volatile char	clock_tenths;	/* 1/10 second counter 0-255 */
+volatile char   clock_msecs;	/* millisecond counter */
+
+/* callbacks provided by lib_clock */
+
+void clock_ms(void);	/* millisecond callback */
+void clock_10(void);	/* 1/10 second callback */
+
+void local_setup(void); /* setup for this project */
+
+void dump_hex(char *, char);	/* dump buffer as hex */
+char loop_check(void);		/* compare loopback RX with TX */
+void tm1638_setup(void);	/* Set up TM1638 contexts. */
+void tm1638_digits(int);	/* Put number in TM1638 data. */
+
+/*
+ *  Time whole updates (all four contexts) with the cycle counter, print
+ *  the count and the free spins to the UART, and stop. An update that
+ *  does not finish is reported as FAIL.
+ */
+//#define BENCH_SPIQ
+
+#ifdef SIM
+#define BENCH_SPIQ
+#endif
+
+void bench_spiq(void);
+
+SPIQ_CTX	tm_mode;	/* TM1638 data command */
+SPIQ_CTX	tm_data;	/* TM1638 display data */
+SPIQ_CTX	tm_keys;	/* TM1638 key read */
+SPIQ_CTX	loop_ctx;	/* MOSI to MISO loopback */
+
+char	tm_mode_tx[1];
+char	tm_data_tx[17];
+char	tm_keys_tx[1];
+char	tm_keys_rx[4];
+char	loop_tx[4];
+char	loop_rx[4];
+
+const char seg_digits[10] = {
+    0x3f, 0x06, 0x5b, 0x4f, 0x66, 0x6d, 0x7d, 0x07, 0x7f, 0x6f
+};
+
+/******************************************************************************
+ *
+ *  Test the queued SPI library
+ */
+
+int main() {
+    char	line[40];
+    char	last_tenth;
+    uint16_t	spins;
+    uint16_t	loop_errors;
+    int		count;
+
+    board_init(0);
+    local_setup();
+    clock_init(clock_ms, clock_10);
+    uart_init(BAUD_115200);
+    spiq_init();
+    tm1638_setup();
+
+    loop_ctx.tx_buf = loop_tx;
+    loop_ctx.rx_buf = loop_rx;
+    loop_ctx.tx_count = 4;
+    loop_ctx.rx_count = 0;	/* not used in duplex */
+    loop_ctx.config =
+	SPIQ_MSB_FIRST |
+	SPIQ_250K  |
+	SPIQ_IDLE_1 |
+	SPIQ_EDGE_2;
+    loop_ctx.flag_bidir = 0;
+    loop_ctx.flag_duplex = 1;	/* RX the same 4 bytes while sending */
+    loop_ctx.cs_odr = 0;	/* no chip select */
+    loop_ctx.setup = 0;
+    loop_ctx.hold = 0;
+#ifdef BENCH_SPIQ
+    bench_spiq();
+#endif
+
+    last_tenth = 0;
+    count = 0;
+    spins = 0;
+    loop_errors = 0;
+    do {
+	if (spiq_busy())
+	    spins++;		/* free time while SPI is running */
+	if (last_tenth == clock_tenths)
+	    continue;
+	last_tenth = clock_tenths;
+	spiq_wait();		/* normally done long before */
+	if (count && loop_check())
+	    loop_errors++;
+
+	count++;
+	tm1638_digits(count);
+	loop_tx[0] = 0xa5;
+	loop_tx[1] = count >> 8;
+	loop_tx[2] = count;
+	loop_tx[3] = 0x5a;
+
+	PA_ODR |= 0x02;		/* A1 is scope trigger */
+	spiq_post(&tm_mode);
+	spiq_post(&tm_data);
+	spiq_post(&tm_keys);
+	spiq_post(&loop_ctx);
+	PA_ODR &= 0xfd;
+
+	if (count % 10)
+	    continue;
+	fmt_line(line, "Spins: %u\r\nLoopback (%u errors):\r\n",
+		 spins, loop_errors);
+	uart_puts(line);
+	dump_hex(loop_rx, 4);
+	uart_puts("Keys:\r\n");
+	dump_hex(tm_keys_rx, 4);
+	spins = 0;
+    } while(1);
+}
+
+#ifdef BENCH_SPIQ
+/******************************************************************************
+ *
+ *  Cycles for updates (BENCH_SPIQ)
+ *  PHASE 1 is SPIQ_UPDATES updates, posted and waited for.
+ */
+
+#define SPIQ_UPDATES	10
+#define SPIQ_SPINS	50000	/* far more than all the updates take */
+
+void bench_spiq(void)
+{
+    char	line[40];
+    uint32_t	start;
+    uint16_t	spins;
+    char	i;
+
+    bench_init();
+    spins = 0;
+    start = bench_read32();
+    for (i = 0; i < SPIQ_UPDATES; i++) {
+	spiq_post(&tm_mode);
+	spiq_post(&tm_data);
+	spiq_post(&tm_keys);
+	spiq_post(&loop_ctx);
+	while (spiq_busy() && spins < SPIQ_SPINS)
+	    spins++;
+    }
+    bench_phase(1, bench_read32() - start);
+
+    if (spins < SPIQ_SPINS) {
+	fmt_line(line, "Spins: %u\r\nPASS\r\n", spins);
+	uart_puts(line);
+    }
+    else
+	uart_puts("FAIL: SPI did not finish\r\n");
+    bench_stop();
+}
+#endif /* BENCH_SPIQ */
+
+/******************************************************************************
+ *
+ *  Set up TM1638 contexts
+ */
+
+void tm1638_setup(void)
+{
+    SPIQ_CTX	*ctx;
+    char	i;
+
+    tm_mode.tx_buf = tm_mode_tx;
+    tm_mode.tx_count = 1;
+    tm_mode.rx_count = 0;
+    tm_mode.flag_duplex = 0;
+    tm_mode_tx[0] = 0x40;	/* data write, incrementing */
+
+    tm_data.tx_buf = tm_data_tx;
+    tm_data.tx_count = 17;
+    tm_data.rx_count = 0;
+    tm_data.flag_duplex = 0;
+    tm_data_tx[0] = 0xc0;	/* start at address zero */
+    for (i = 1; i < 17; i++)
+	tm_data_tx[i] = 0;
+
+    tm_keys.tx_buf = tm_keys_tx;
+    tm_keys.rx_buf = tm_keys_rx;
+    tm_keys.tx_count = 1;
+    tm_keys.rx_count = 4;	/* keys encoded into 4 bytes */
+    tm_keys.flag_duplex = 0;
+    tm_keys_tx[0] = 0x42;	/* read keypad */
+
+    for (i = 0; i < 3; i++) {
+	ctx = i == 0 ? &tm_mode : i == 1 ? &tm_data : &tm_keys;
+	ctx->config =
+	    SPIQ_LSB_FIRST |	/* TM1638 is little-endian. */
+	    SPIQ_1MHZ   |	/* Minimum clock pulse is 400ns. */
+	    SPIQ_IDLE_1 |
+	    SPIQ_EDGE_2;
+	ctx->flag_bidir = 1;	/* data pin is bidirectional */
+	ctx->cs_odr = &PA_ODR;	/* strobe (A3) is active low */
+	ctx->cs_mask = 0x08;
+	ctx->setup = 2;		/* also the 1 usec wait before read */
+	ctx->hold = 1;
+    }
+
+    tm_mode_tx[0] = 0x8f;	/* enable display, maximum brightness */
+    spiq_post(&tm_mode);
+    spiq_wait();
+    tm_mode_tx[0] = 0x40;
+}
+
+/******************************************************************************
+ *
+ *  Put number in TM1638 data
+ *  in: number
+ */
+
+void tm1638_digits(int val)
+{
+    char	dec[6];
+    char	i;
+
+    bin16_dec_fast(val, dec);
+    for (i = 0; i < 5; i++)
+	tm_data_tx[7 + i * 2] = seg_digits[dec[i] - '0'];
+}
+
+/******************************************************************************
+ *
+ *  Compare loopback RX with TX
+ *  out: zero if same
+ */
+
+char loop_check(void)
+{
+    char	i;
+
+    for (i = 0; i < 4; i++)
+	if (loop_rx[i] != loop_tx[i])
+	    return 1;
+    return 0;
+}
+
+/******************************************************************************
+ *
+ *  Dump buffer as hex
+ *  in: buffer, size
+ */
+
+void dump_hex(char *buf, char size)
+{
+    char	line[52];
+    char	*lp;
+
+    lp = line;
+    while (size--)
+	lp = fmt_line(lp, "%x ", *buf++);
+    fmt_line(lp, "\r\n");
+    uart_puts(line);
+}
+
+/******************************************************************************
+ *
+ *  Millisecond callback from lib_clock
+ */
+
+void clock_ms(void)
+{
+    clock_msecs++;
+}
+
+/******************************************************************************
+ *
+ *  1/10 second callback from lib_clock
+ */
+
+void clock_10(void)
+{
+    static char blink;
+
+    clock_tenths++;
+
+    blink++;
+    if (blink < 4) {
+        board_led(blink & 1);   /* blink twice */
+        return;
+    }
+    board_led(0);               /* off for 7/10 second */
+    if (blink < 10)
+        return;
+    blink = 0;
+}
+
+/******************************************************************************
+ *
+ * I/O Ports on STM8S103F:
+ *
+ * A1..A3       A3 is HS
+ * B4..B5       Open drain
+ * C3..C7       HS
+ * D1..D6       HS
+ *
+ * SPI PINS for STM8S103F and STM8S003F:
+ *
+ * Clock:  C5 (pin 15)  Master output
+ * MOSI:   C6 (pin 16)  Master output, slave input
+ * MISO:   C7 (pin 17)  Master input, slave output
+ *
+ * Testing with TM1638:
+ * CLK: C5
+ * DIO: C6  Bidirectional I/O
+ * STB: A3  Strobe goes low for transaction, then returns high.
+ *
+ ******************************************************************************
+ *
+ *  Local setup
+ */
+
+void local_setup(void)
+{
+    PA_DDR |= 0x0a;		/* A1 is oscilloscope signal, A3 strobe. */
+    PA_CR1 |= 0x0a;		/* Push-pull output. */
+
+    PA_ODR = 8;			/* Strobe is active low. */
+}
@@ -1,7 +1,7 @@
 /*
  *  File name:  test_tm1637.c
  *  Date first: 06/10/2018
- *  Date last:  06/14/2019
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for TM1637 library.
  *
@@ -14,13 +14,16 @@
  *
  ******************************************************************************
  *
+ *  Built with -DSIM ("make sim"), time the display calls instead.
  */
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
 #include "lib_clock.h"
 #include "lib_tm1637.h"
+#include "lib_uart.h"
 
 void timer_ms(void);	/* millisecond timer call */
 void timer_10(void);	/* 1/10 second timer call */
@@ -37,6 +40,18 @@ void setup(void);
 /* Uncomment to test blink function */
 //#define TEST_BLINK	/* test blink function: 8 seconds on, 8 off */
 
+/*
+ *  Time word writes and polls with the cycle counter, print the counts
+ *  to the UART, and stop. The module does not have to be there.
+ */
+//#define BENCH_TM1637
+
+#ifdef SIM
+#define BENCH_TM1637
+#endif
+
+void bench_tm1637(void);
+
 static void show_status(void);
 
 #pragma disable_warning 196	/* "pointer lost const" */
@@ -59,6 +74,9 @@ int main() {
     setup();
     tm1637_init();
     tm1637_bright(7);
+#ifdef BENCH_TM1637
+    bench_tm1637();
+#endif
     clock_init(timer_ms, timer_10);
 
     count16 = 0;
@@ -109,6 +127,40 @@ int main() {
     } while(1);
 }
 
+#ifdef BENCH_TM1637
+/******************************************************************************
+ *
+ *  Cycles for display calls (BENCH_TM1637)
+ *  PHASE 1 is TM1637_WORDS words written, PHASE 2 as many polls.
+ */
+
+#define TM1637_WORDS	10
+
+void bench_tm1637(void)
+{
+    uint32_t	start;
+    char	i;
+
+    uart_init(BAUD_115200);
+    bench_init();
+    uart_puts("TM1637 cycles\r\n");
+
+    start = bench_read32();
+    for (i = 0; i < TM1637_WORDS; i++) {
+	tm1637_curs(0);
+	tm1637_puts(words[i]);
+    }
+    bench_phase(1, bench_read32() - start);
+
+    start = bench_read32();
+    for (i = 0; i < TM1637_WORDS; i++)
+	tm1637_poll();
+    bench_phase(2, bench_read32() - start);
+
+    bench_stop();
+}
+#endif /* BENCH_TM1637 */
+
 /******************************************************************************
  *
  *  Board and globals setup
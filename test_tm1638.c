@@ -1,7 +1,7 @@
 /*
  *  File name:  test_tm1638.c
  *  Date first: 06/10/2018
- *  Date last:  06/24/2018
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for TM1638 library.
  *
@@ -12,13 +12,58 @@
  *
  ******************************************************************************
  *
+ *  Built with -DSIM ("make sim"), time the display and key polls instead.
  */
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
 #include "lib_clock.h"
+#include "lib_uart.h"
+
+/*
+ *  SHADOW uses lib_tm1638fb: writes go to a copy of the display RAM,
+ *  and the millisecond poll sends only what changed, so there is no
+ *  push for the 16 key module. Comment it out to use lib_tm1638.
+ */
+#define SHADOW
+
+/*
+ *  Time the millisecond poll with and without display changes, and
+ *  lib_keyq, with the cycle counter. Print the counts to the UART and
+ *  stop. The module does not have to be there.
+ */
+//#define BENCH_TM1638
+
+#ifdef SIM
+#define BENCH_TM1638
+#endif
+#if defined(BENCH_TM1638) && !defined(SHADOW)
+#error BENCH_TM1638 needs SHADOW
+#endif
+
+#ifdef SHADOW
+#include "lib_tm1638fb.h"
+#define TM1638_8	TMFB_8
+#define TM1638_16	TMFB_16
+#define tm1638_init	tmfb_init
+#define tm1638_bright	tmfb_bright
+#define tm1638_blink	tmfb_blink
+#define tm1638_curs	tmfb_curs
+#define tm1638_putc	tmfb_putc
+#define tm1638_puts	tmfb_puts
+#define tm1638_setled	tmfb_setled
+#define tm1638_kmap	tmfb_kmap
+#define tm1638_getc	tmfb_getc
+#define tm1638_poll	tmfb_poll
+#define tm1638_push()
+#include "lib_keyq.h"
+#define KEY_LONG	600	/* ms to long press (clears display) */
+#define KEY_REPEAT	150	/* ms between repeats after that */
+#else
 #include "lib_tm1638.h"
+#endif
 
 void timer_ms(void);	/* millisecond timer call */
 void timer_10(void);	/* 1/10 second timer call */
@@ -36,12 +81,14 @@ const char *words[];
 //#define SHOW_CLOCK	/* show incrementing clock */
 #define SHOW_WORDS	/* show selected words */
 //#define SHOW_KEYS	/* read keys and echo to display */
+			/* (with SHADOW: from lib_keyq, none lost) */
 
 /* Blink test may be combined with anything */
 //#define TEST_BLINK	/* test blink function: 8 seconds on, 8 off */
 
 static void test_keys(void);
 static void show_status(void);
+void bench_tm1638(void);
 
 #pragma disable_warning 196	/* "pointer lost const" */
 
@@ -62,9 +109,14 @@ int main() {
     setup();
     tm1638_init(module_type);
     tm1638_bright(4);
-    clock_init(timer_ms, timer_10);
-
 //    tm1638_kmap("01234567");	/* load custom keyboard map */
+#ifdef SHADOW
+    keyq_init(tmfb_kmap_get(), KEY_LONG, KEY_REPEAT);	/* long press */
+#endif
+#ifdef BENCH_TM1638
+    bench_tm1638();
+#endif
+    clock_init(timer_ms, timer_10);
 
     count16 = 0;
     wptr = 0;
@@ -121,6 +173,54 @@ int main() {
     } while(1);
 }
 
+#ifdef BENCH_TM1638
+/******************************************************************************
+ *
+ *  Cycles for polls (BENCH_TM1638)
+ *  PHASE 1 is BENCH_POLLS polls with no change (key scans and
+ *  keyq_poll() included),
+ *  PHASE 2 is a number written then polled out, BENCH_NUMBERS times,
+ *  PHASE 3 is BENCH_POLLS calls of keyq_poll() alone, with no keys.
+ */
+
+#define BENCH_POLLS	1000
+#define BENCH_NUMBERS	100
+
+void bench_tm1638(void)
+{
+    char	decimal[6];
+    uint32_t	start;
+    int		i;
+    char	j;
+
+    uart_init(BAUD_115200);
+    bench_init();
+    uart_puts("TM1638 poll cycles\r\n");
+
+    start = bench_read32();
+    for (i = 0; i < BENCH_POLLS; i++)
+	tm1638_poll();
+    bench_phase(1, bench_read32() - start);
+
+    start = bench_read32();
+    for (i = 0; i < BENCH_NUMBERS; i++) {
+	bin16_dec(i, decimal);
+	tm1638_curs(3);
+	tm1638_puts(decimal);
+	for (j = 0; j < TMFB_SCAN; j++)
+	    tm1638_poll();	/* a scan and a push */
+    }
+    bench_phase(2, bench_read32() - start);
+
+    start = bench_read32();
+    for (i = 0; i < BENCH_POLLS; i++)
+	keyq_poll(0);
+    bench_phase(3, bench_read32() - start);
+
+    bench_stop();
+}
+#endif /* BENCH_TM1638 */
+
 /******************************************************************************
  *
  *  Board and globals setup
@@ -152,7 +252,7 @@ void setup(void)
 
 void timer_ms(void)
 {
-    tm1638_poll();
+    tm1638_poll();		/* with SHADOW, also keyq_poll() */
 }
 
 /******************************************************************************
@@ -170,10 +270,38 @@ void timer_10(void)
  *  Display keys and indicate with LED
  *  (Note the Press/Release LED is based on the returned character.
  *   Loading a custom keymap will change the LED positions.)
+ *  With SHADOW, a long press clears the display and then repeats the
+ *  key, and two keys together show '-'.
  */
 
 static void test_keys(void)
 {
+#ifdef SHADOW
+    KEYQ_EVENT	ev;
+
+    while (keyq_get(&ev)) {	/* all events since last time */
+	switch (ev.type) {
+	case KEYQ_PRESS:
+	    tm1638_setled(ev.code & 7, 1);
+	    tm1638_putc(ev.code);
+	    break;
+	case KEYQ_RELEASE:
+	    tm1638_setled(ev.code & 7, 0);
+	    break;
+	case KEYQ_CHORD:
+	    tm1638_putc('-');
+	    break;
+	case KEYQ_LONG:
+	    tm1638_curs(0);
+	    tm1638_puts("        ");
+	    tm1638_curs(0);
+	    break;
+	case KEYQ_REPEAT:
+	    tm1638_putc(ev.code);
+	    break;
+	}
+    }
+#else
     char	key;
 
     key = tm1638_getc();
@@ -187,6 +315,7 @@ static void test_keys(void)
 	if (module_type == TM1638_16)
 	    tm1638_push();
     }
+#endif
 }
 
 /******************************************************************************
@@ -1,7 +1,7 @@
 /*
  *  File name:  test_uart.c
  *  Date first: 09/17/2022
- *  Date last:  09/18/2022
+ *  Date last:  10/17/2026
  *
  *  Description: Test and example program for STM8 UART library.
  *
@@ -20,10 +20,13 @@
  *  When byte is received, print it as ASCII and hex, except
  *  backspace (0x08) prints a long message.
  *  Otherwise, print the clock uptime every second.
+ *
+ *  Built with -DSIM ("make sim"), time the long message instead.
  */
 
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
 #include "lib_board.h"
 #include "lib_clock.h"
@@ -43,6 +46,18 @@ const char *mesg;
 
 #define KEY_FOR_MESSAGE 8	/* Backspace to print message. */
 
+/*
+ *  Time the long message with the cycle counter, print the count to
+ *  the UART, and stop. No input is needed.
+ */
+//#define BENCH_UART
+
+#ifdef SIM
+#define BENCH_UART
+#endif
+
+void bench_uart(void);
+
 /******************************************************************************
  *
  *  Test the UART library.
@@ -58,6 +73,9 @@ int main() {
 
     uart_puts("UART test. Press BACKSPACE for message.\r\n"
 	      "Other keys echo back with hex value.\r\n");
+#ifdef BENCH_UART
+    bench_uart();
+#endif
     clock_last = clock_tenths;
     for (;;) {
 	if (uart_rsize())
@@ -108,6 +126,26 @@ void show_clock(void)
     uart_crlf();
 }
 
+#ifdef BENCH_UART
+/******************************************************************************
+ *
+ *  Cycles for the long message (BENCH_UART)
+ *  PHASE 1 is uart_puts() of the message, which waits for the buffer.
+ */
+
+void bench_uart(void)
+{
+    uint32_t	start;
+
+    bench_init();
+    start = bench_read32();
+    uart_puts((char *)mesg);
+    bench_phase(1, bench_read32() - start);
+
+    bench_stop();
+}
+#endif /* BENCH_UART */
+
 /******************************************************************************
  *
  *  Board and globals setup
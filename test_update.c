@@ -0,0 +1,179 @@
+/*
+ *  File name:  test_update.c
+ *  Date first: 10/17/2026
+ *  Date last:  10/17/2026
+ *
+ *  Description: Test and example program for UART flash update.
+ *
+ *  Author:     Richard Hodges
+ *
+ *  Copyright (C) 2026 Richard Hodges. All rights reserved.
+ *  Permission is hereby granted for any use.
+ *
+ ******************************************************************************
+ *
+ *  Receive a binary image over the UART at 115200 and program it into
+ *  the update area, then report blocks, rejected frames, and bytes per
+ *  second. Send it from Linux with:
+ *
+ *	host/send_update /dev/ttyUSB0 image.bin 0x9000
+ *
+ *  with the address from the "Ready for update" line (FREE_BASE).
+ *
+ *  TX is pin D5
+ *  RX is pin D6
+ *
+ *  The board LED is on while an update is running.
+ *
+ *  Built with -DSIM ("make sim"), time the frame CRC instead.
+ */
+
+#include "stm8s_header.h"
+
+#include "lib_bench.h"
+#include "lib_board.h"
+#include "lib_clock.h"
+#include "lib_crc.h"
+#include "lib_flash.h"
+#include "lib_flashblk.h"
+#include "lib_format.h"
+#include "lib_uart.h"
+#include "lib_update.h"
+
+/*
+ *  Update area, from FREE_BASE in the Makefile to the end of flash. The
+ *  Makefile checks after linking that the program ends below it, so an
+ *  update can not overwrite the receiver.
+ */
+#ifndef FREE_BASE
+#error FREE_BASE comes from the Makefile
+#endif
+#ifdef STM8105
+#define FLASH_END	0x10000		/* 32K */
+#else
+#define FLASH_END	0xa000		/* 8K */
+#endif
+#define UPD_BASE	((char *)FREE_BASE)
+#define UPD_SIZE	((int)(FLASH_END - FREE_BASE))
+
+/*
+ *  Time the CRC of one frame, a byte at a time as lib_update does it
+ *  while the frame arrives, print the count to the UART, and stop.
+ *  Nothing is received or programmed.
+ */
+//#define BENCH_UPDATE
+
+#ifdef SIM
+#define BENCH_UPDATE
+#endif
+
+void timer_ms(void);	/* millisecond timer call */
+void timer_10(void);	/* 1/10 second timer call */
+
+void update(void);
+void bench_update(void);
+
+/******************************************************************************
+ *
+ *  Test the UART update library.
+ */
+
+int main() {
+    board_init(0);
+    clock_init(timer_ms, timer_10);
+    uart_init(BAUD_115200);
+    flash_init();
+    flashblk_init();
+#ifdef BENCH_UPDATE
+    bench_init();
+    bench_update();
+#endif
+    bench_init_ms();	/* block writes turn interrupts off */
+
+    for (;;)
+	update();
+}
+
+/******************************************************************************
+ *
+ *  Receive one update and report
+ */
+
+void update(void)
+{
+    UPD_STAT	stat;
+    char	line[64];
+    char	retval;
+    uint32_t	start, ms, bytes;
+
+    upd_init(UPD_BASE, UPD_SIZE);
+    fmt_line(line, "Ready for update at %x%x, %u bytes\r\n",
+	     (uint16_t)UPD_BASE >> 8, (uint16_t)UPD_BASE, UPD_SIZE);
+    uart_puts(line);
+
+    while (!uart_rsize())
+	;
+    start = bench_read32();	/* timed from first byte (SOH) */
+    board_led(1);
+    do {
+	retval = upd_poll();
+    } while (retval != UPD_DONE);
+    ms = bench_read32() - start;
+    board_led(0);
+
+    upd_stat(&stat);
+    bytes = (uint32_t)stat.blocks * FLASHBLK_SIZE;
+    fmt_line(line, "Blocks: %u Errors: %u Bytes: %lu ms: %lu\r\n",
+	     stat.blocks, stat.errors, bytes, ms);
+    uart_puts(line);
+    if (!ms)
+	ms = 1;
+    fmt_line(line, "%lu bytes/sec\r\n", bytes * 1000 / ms);
+    uart_puts(line);
+}
+
+#ifdef BENCH_UPDATE
+/******************************************************************************
+ *
+ *  Cycles for the CRC of one frame (BENCH_UPDATE)
+ *  PHASE 1 is address, count and data, one crc16_update() per byte.
+ */
+
+static char	bench_frame[3 + FLASHBLK_SIZE];
+volatile uint16_t bench_crc;
+
+void bench_update(void)
+{
+    uint32_t	start;
+    uint16_t	crc;
+    uint8_t	i;
+
+    start = bench_read32();
+    crc = CRC16_INIT;
+    for (i = 0; i < sizeof(bench_frame); i++)
+	crc = crc16_update(crc, &bench_frame[i], 1);
+    bench_phase(1, bench_read32() - start);
+    bench_crc = crc;
+
+    bench_stop();
+}
+#endif /* BENCH_UPDATE */
+
+/******************************************************************************
+ *
+ *  Millisecond timer callback
+ */
+
+void timer_ms(void)
+{
+    upd_tick();
+}
+
+/******************************************************************************
+ *
+ *  Tenths second timer callback
+ */
+
+void timer_10(void)
+{
+}
@@ -1,7 +1,7 @@
 /*
  *  File name:  test_w1209.c
  *  Date first: 02/22/2019
- *  Date last:  06/14/2019
+ *  Date last:  10/17/2026
  *
  *  Description: Test/Example for STM8 Library for W1209 thermostat board.
  *
@@ -14,11 +14,20 @@
  *
  */
 
+#include <math.h>
+#include <stdint.h>
+
 #include "stm8s_header.h"
 
+#include "lib_bench.h"
 #include "lib_bindec.h"
 #include "lib_clock.h"
+#include "lib_decim.h"
+#include "lib_fastdec.h"
+#include "lib_thermo.h"
+#include "lib_uart.h"
 #include "lib_w1209.h"
+#include "thermo_lut.h"
 
 volatile char	clock_tenths;	/* 1/10 second counter 0-255 */
 volatile char   clock_msecs;	/* millisecond counter */
@@ -37,6 +46,43 @@ const char *words[];	/* words that can be shown on LED */
 //#define SHOW_NUMBER	/* show incrementing number */
 //#define SHOW_WORDS	/* show selected words */
 #define SHOW_PROBE	/* show raw probe value */
+//#define SHOW_TEMP	/* show probe temperature (C) */
+
+/*  Run relay as a heater thermostat (keys 1 and 2 move setpoint)  */
+
+//#define THERMOSTAT
+
+#define SETPOINT	250	/* tenths C */
+
+/*  Read probe every millisecond, and average for extra bits  */
+
+//#define OVERSAMPLE
+
+#define PROBE_BITS	3	/* extra bits, 64 samples */
+
+/*
+ *  Time thermo_temp() and thermo_temp16() against the same conversion
+ *  in float (Steinhart-Hart with only the beta term), for every probe
+ *  reading. Print the cycles per reading to the UART, and stop. No
+ *  probe is needed. Compare the .map sizes with it on and off to see
+ *  what the float library costs in flash.
+ */
+//#define BENCH_TEMP
+
+#ifdef SIM
+#define BENCH_TEMP
+#endif
+
+#ifdef THERMOSTAT
+THERMO		thermo;
+#endif
+#ifdef OVERSAMPLE
+DECIM		probe;
+#endif
+
+int probe_temp(void);	/* probe temperature */
+void show_temp(int);	/* show whole degrees */
+void bench_temp(void);	/* time conversions */
 
 /******************************************************************************
  *
@@ -46,15 +92,29 @@ const char *words[];	/* words that can be shown on LED */
  *  Show key press/release in hex.
  *  Engage relay and LED while any key is pressed.
  *  Button #1 ends blink, #2 starts fast blink, #3 starts slow blink
+ *
+ *  With THERMOSTAT, run the relay from the probe every 1/10 second,
+ *  and keys #2 and #3 move the setpoint by 1 C.
+ *  With OVERSAMPLE, the temperature comes from 64 probe readings.
+ *  With BENCH_TEMP, time the probe conversions and stop.
  */
 
 int main() {
     char	display[6];
     char	next_tenth;
+#ifdef THERMOSTAT
+    char	last_tenth;
+#endif
     int		secs;
     char	key, wptr;
 
+#ifdef BENCH_TEMP
+    bench_temp();
+#endif
     w12_init();
+#ifdef OVERSAMPLE
+    decim_init(&probe, PROBE_BITS);
+#endif
     clock_init(clock_ms, clock_10);
 
     display;			/* suppress warning */
@@ -65,11 +125,28 @@ int main() {
     w12_relay(1);		/* turn on LED to show reset */
     w12_puts("[-]");
 
+#ifdef THERMOSTAT
+    thermo.mode = THERMO_HEAT | THERMO_HYST;
+    thermo.setpoint = SETPOINT;
+    thermo.hyst = 10;		/* 1 C */
+    thermo.min_on = 100;	/* 10 seconds */
+    thermo.min_off = 100;
+    thermo_reset(&thermo);
+    last_tenth = clock_tenths;
+#endif
+
     do {
 	key = w12_getc();
 	if (key)
 	    do_key(key);
 
+#ifdef THERMOSTAT
+	if (last_tenth != clock_tenths) {
+	    last_tenth++;
+	    w12_relay(thermo_tick(&thermo, probe_temp()));
+	}
+#endif
+
 	if (next_tenth != clock_tenths)
 	    continue;		/* wait for next whole second */
 	next_tenth = clock_tenths + 10;
@@ -88,10 +165,59 @@ int main() {
 #ifdef SHOW_PROBE
 	bin16_dec(w12_probe(), display);
 	w12_puts(display + 2);
+#endif
+#ifdef SHOW_TEMP
+	show_temp(probe_temp());
 #endif
     } while(1);
 }
 
+/******************************************************************************
+ *
+ *  Probe temperature, from the oversampled reading if there is one
+ *  out: tenths C, or THERMO_FAULT
+ */
+
+int probe_temp(void)
+{
+#ifdef OVERSAMPLE
+    uint16_t	adc;
+
+    adc = decim_read(&probe);
+    if (adc == DECIM_NONE)
+	return THERMO_FAULT;	/* first block not done */
+    return thermo_temp16(adc << (6 - PROBE_BITS));
+#else
+    return thermo_temp(w12_probe());
+#endif
+}
+
+/******************************************************************************
+ *
+ *  Show temperature in whole degrees, "-99" to "999"
+ *  in: tenths C, or THERMO_FAULT
+ */
+
+void show_temp(int temp)
+{
+    char	display[6];
+    char	neg;
+
+    if (temp == THERMO_FAULT) {
+	w12_puts("---");
+	return;
+    }
+    neg = 0;
+    if (temp < 0) {
+	neg = 1;
+	temp = -temp;
+    }
+    bin16_dec((temp + 5) / 10, display);
+    if (neg)
+	display[2] = '-';
+    w12_puts(display + 2);
+}
+
 /******************************************************************************
  *
  *  Do something with keypress (or release)
@@ -102,6 +228,17 @@ void do_key(char key)
 {
     char	display[6];
 
+#ifdef THERMOSTAT
+    switch (key) {
+    case '1' : thermo.setpoint -= 10; break;
+    case '2' : thermo.setpoint += 10; break;
+    }
+    if (key == '1' || key == '2') {
+	w12_curs(0);
+	show_temp(thermo.setpoint);
+    }
+    display;			/* suppress warning */
+#else
     if (key & 0x80)
 	w12_relay(0);	/* key release turns off relay */
     else
@@ -112,10 +249,11 @@ void do_key(char key)
     case '1' : w12_blink(10); break;
     case '2' : w12_blink(25); break;
     }
-    bin8_hex(key, display);
+    bin8_hex_fast(key, display);
     w12_curs(0);
     w12_puts(display);		/* release will have bit-7 set */
     w12_putc('-');
+#endif
 }
 
 /******************************************************************************
@@ -127,6 +265,9 @@ void clock_ms(void)
 {
     clock_msecs++;
     w12_poll();
+#ifdef OVERSAMPLE
+    decim_add(&probe, w12_probe());
+#endif
 }
 
 /******************************************************************************
@@ -139,6 +280,69 @@ void clock_10(void)
     clock_tenths++;
 }
 
+#ifdef BENCH_TEMP
+/******************************************************************************
+ *
+ *  Probe reading to temperature in float, the usual way
+ *  in: ADC value (THERMO_ADC_MIN to THERMO_ADC_MAX)
+ *  out: tenths C
+ */
+
+int float_temp(uint16_t adc)
+{
+    float	r;
+
+    r = (float)NTC_RDIV * adc * NTC_VREF /
+	(1024.0 * NTC_VSUP - (float)adc * NTC_VREF);
+    return (1.0 / (1.0 / 298.15 + logf(r / NTC_R25) / NTC_BETA)
+	    - 273.15) * 10;
+}
+
+/******************************************************************************
+ *
+ *  Cycles for table lookup against float (BENCH_TEMP)
+ *  PHASE 1-3 are the totals over the whole ADC range.
+ */
+
+volatile int	bench_sink;
+
+void bench_temp(void)
+{
+    BENCH_STAT	table, table16, flt;
+    uint16_t	start, end, adc;
+
+    uart_init(BAUD_115200);
+    bench_init();
+    bench_clear(&table);
+    bench_clear(&table16);
+    bench_clear(&flt);
+
+    for (adc = THERMO_ADC_MIN; adc <= THERMO_ADC_MAX; adc++) {
+	start = bench_read();
+	bench_sink = thermo_temp(adc);
+	end = bench_read();
+	bench_add(&table, end - start);
+
+	start = bench_read();
+	bench_sink = thermo_temp16(adc << 6);
+	end = bench_read();
+	bench_add(&table16, end - start);
+
+	start = bench_read();
+	bench_sink = float_temp(adc);
+	end = bench_read();
+	bench_add(&flt, end - start);
+    }
+    bench_print("thermo_temp cycles", &table);
+    bench_print("thermo_temp16 cycles", &table16);
+    bench_print("float cycles", &flt);
+    bench_phase(1, table.sum);
+    bench_phase(2, table16.sum);
+    bench_phase(3, flt.sum);
+    bench_stop();
+}
+#endif
+
 /******************************************************************************
  *
  *  Words that can be shown